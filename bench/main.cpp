@@ -0,0 +1,399 @@
+// Headless microbenchmarks for the transform controls math.
+// Build with -DITC_HEADLESS=ON (no Geode SDK needed) and run ITCBenchmark [iterations]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+#include "core/AngleHistogram.hpp"
+#include "core/Geometry.hpp"
+#include "core/OrientedBounds.hpp"
+#include "core/SnapLines.hpp"
+#include "core/SpatialGrid.hpp"
+#include "core/TransformFrame.hpp"
+#include "core/TransformKernel.hpp"
+#include "core/TransformQueue.hpp"
+#include "core/WorkerPool.hpp"
+
+using namespace itc;
+
+namespace {
+
+struct Sample {
+	HandlePositions m_handles;
+	float m_rotation;
+	float m_limit;
+	Vec2 m_anchor;
+};
+
+// random transform rect (with some warp) + random anchor around it
+std::vector<Sample> makeSamples(size_t count, uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> size(1.f, 600.f);
+	std::uniform_real_distribution<float> warp(-0.5f, 0.5f);
+	std::uniform_real_distribution<float> rot(-180.f, 180.f);
+	std::uniform_real_distribution<float> unit(-1.3f, 1.3f);
+	std::uniform_real_distribution<float> scale(0.5f, 2.f);
+	std::vector<Sample> samples(count);
+	for (auto& s : samples) {
+		const float w = size(rng) / 2, h = size(rng) / 2, k = warp(rng);
+		auto& p = s.m_handles.m_pos;
+		p[6] = {-w + k * h, h}; p[7] = {w + k * h, h};
+		p[8] = {-w - k * h, -h}; p[9] = {w - k * h, -h};
+		p[4] = (p[6] + p[7]) / 2.f; p[5] = (p[8] + p[9]) / 2.f;
+		p[2] = (p[6] + p[8]) / 2.f; p[3] = (p[7] + p[9]) / 2.f;
+		s.m_rotation = rot(rng);
+		s.m_limit = scale(rng) * 18;
+		// pick either a random point or a point close to one of the handles
+		const Vec2 local = (rng() & 1) ? p[2 + rng() % 8] + Vec2{unit(rng), unit(rng)} * 10.f
+			: Vec2{unit(rng) * w, unit(rng) * h};
+		s.m_anchor = fromMainNodeSpace(local, s.m_rotation);
+	}
+	return samples;
+}
+
+template <class F>
+void run(const char* name, const std::vector<Sample>& samples, size_t iterations, F&& func) {
+	size_t hits = 0;
+	const auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < iterations; i++) {
+		hits += func(samples[i % samples.size()]);
+	}
+	const auto end = std::chrono::steady_clock::now();
+	const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+	std::printf("%-28s %10.2f ns/op  %8.2f Mops/s  (hits: %zu)\n",
+		name, ns / iterations, iterations / ns * 1000.0, hits);
+}
+
+ObjectBuffer makeObjects(size_t count, uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> pos(0.f, 30000.f), rot(-180.f, 180.f), scale(0.5f, 2.f);
+	ObjectBuffer objects;
+	objects.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		objects.m_x[i] = pos(rng);
+		objects.m_y[i] = pos(rng) / 10;
+		objects.m_rotX[i] = objects.m_rotY[i] = rot(rng);
+		objects.m_scaleX[i] = objects.m_scaleY[i] = scale(rng);
+	}
+	return objects;
+}
+
+float maxDifference(const ObjectBuffer& a, const ObjectBuffer& b) {
+	float diff = 0;
+	const std::vector<float> ObjectBuffer::* fields[] = {&ObjectBuffer::m_x, &ObjectBuffer::m_y,
+		&ObjectBuffer::m_rotX, &ObjectBuffer::m_rotY, &ObjectBuffer::m_scaleX, &ObjectBuffer::m_scaleY};
+	for (auto field : fields) {
+		for (size_t i = 0; i < a.size(); i++) {
+			diff = std::max(diff, std::abs((a.*field)[i] - (b.*field)[i]));
+		}
+	}
+	return diff;
+}
+
+// objects per second of the transform kernels
+template <class F>
+void runKernel(const char* name, size_t count, size_t totalObjects, F&& func) {
+	const size_t repeats = std::max<size_t>(1, totalObjects / count);
+	const auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < repeats; i++) func(i);
+	const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::printf("%-28s %8zu objs  %10.2f Mobj/s\n", name, count, repeats * count / s / 1e6);
+}
+
+void benchmarkKernels(size_t totalObjects) {
+	for (size_t count : {1'000, 10'000, 100'000}) {
+		const auto src = makeObjects(count, 7);
+		ObjectBuffer scalar, simd;
+		scalar.resize(count);
+		simd.resize(count);
+		auto transformFor = [](size_t i) {
+			ObjectTransform t;
+			t.m_matrix = (Affine::rotation(float(i % 360)) * Affine::scale(1.5f, 0.75f)).about({15000, 1500});
+			t.m_rotX = t.m_rotY = float(i % 360);
+			t.m_scaleX = 1.5f;
+			t.m_scaleY = 0.75f;
+			return t;
+		};
+		runKernel("applyTransformScalar", count, totalObjects, [&](size_t i) {
+			applyTransformScalar(src, scalar, transformFor(i), 0, count);
+		});
+		runKernel("applyTransformSimd", count, totalObjects, [&](size_t i) {
+			applyTransformSimd(src, simd, transformFor(i), 0, count);
+		});
+		// check the kernel against the scalar reference
+		applyTransformScalar(src, scalar, transformFor(123), 0, count);
+		applyTransformSimd(src, simd, transformFor(123), 0, count);
+		const float diff = maxDifference(scalar, simd);
+		std::printf("%-28s %8zu objs  max diff %g%s\n", "simd vs scalar", count, diff, diff > 1e-3f ? "  MISMATCH" : "");
+	}
+}
+
+// every object scaled / rotated about its own center (pivots are the positions shifted by
+// half an object), checked against the per object matrix
+void benchmarkPivotKernels(size_t totalObjects) {
+	const size_t count = 100'000;
+	const auto src = makeObjects(count, 11);
+	std::vector<float> pivotX(count), pivotY(count);
+	for (size_t i = 0; i < count; i++) {
+		pivotX[i] = src.m_x[i] + 15;
+		pivotY[i] = src.m_y[i] - 15;
+	}
+	ObjectTransform t;
+	t.m_matrix = Affine::rotation(30) * Affine::scale(2, 2);
+	t.m_rotX = t.m_rotY = 30;
+	t.m_scaleX = t.m_scaleY = 2;
+	const Vec2 move = {40, -10};
+	ObjectBuffer scalar, simd, reference;
+	scalar.resize(count);
+	simd.resize(count);
+	reference.resize(count);
+	runKernel("applyPivotTransformScalar", count, totalObjects, [&](size_t) {
+		applyPivotTransformScalar(src, pivotX.data(), pivotY.data(), scalar, t, move, 0, count);
+	});
+	runKernel("applyPivotTransformSimd", count, totalObjects, [&](size_t) {
+		applyPivotTransformSimd(src, pivotX.data(), pivotY.data(), simd, t, move, 0, count);
+	});
+	for (size_t i = 0; i < count; i++) {
+		ObjectTransform own = t;
+		own.m_matrix = Affine::translation(move) * t.m_matrix.about({pivotX[i], pivotY[i]});
+		applyTransformScalar(src, reference, own, i, i + 1);
+	}
+	std::printf("%-28s %8zu objs  max diff %g / %g\n", "pivot simd / per object", count,
+		maxDifference(scalar, simd), maxDifference(scalar, reference));
+}
+
+void benchmarkParallel(size_t totalObjects) {
+	const unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+	for (size_t count : {30'000, 100'000, 1'000'000}) {
+		const auto src = makeObjects(count, 11);
+		ObjectTransform t;
+		t.m_matrix = (Affine::rotation(33) * Affine::scale(1.25f, 1.25f)).about({15000, 1500});
+		t.m_rotX = t.m_rotY = 33;
+		t.m_scaleX = t.m_scaleY = 1.25f;
+		ObjectBuffer reference;
+		reference.resize(count);
+		applyTransformSimd(src, reference, t, 0, count);
+		for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+			WorkerPool pool(threads - 1);
+			ObjectBuffer dst;
+			dst.resize(count);
+			char name[64];
+			std::snprintf(name, sizeof(name), "applyTransformParallel x%u", threads);
+			runKernel(name, count, totalObjects, [&](size_t) { applyTransformParallel(src, dst, t, pool); });
+			// must be deterministic regardless of the thread count
+			if (maxDifference(dst, reference) != 0) std::printf("  MISMATCH with %u threads\n", threads);
+		}
+	}
+}
+
+// rotate + scale + mirror + rotate: one composed pass vs one pass per operation
+void benchmarkQueue(size_t totalObjects) {
+	const size_t count = 100'000;
+	const auto src = makeObjects(count, 13);
+	const Vec2 pivot = {15000, 1500};
+	TransformQueue steps[4];
+	steps[0].rotate(30, pivot);
+	steps[1].scale(1.5f, pivot);
+	steps[2].mirrorX(pivot);
+	steps[3].rotate(-75, pivot);
+	TransformQueue queue;
+	queue.rotate(30, pivot);
+	queue.scale(1.5f, pivot);
+	queue.mirrorX(pivot);
+	queue.rotate(-75, pivot);
+
+	ObjectBuffer composed, stepped, tmp;
+	composed.resize(count);
+	stepped.resize(count);
+	tmp.resize(count);
+	runKernel("TransformQueue composed", count, totalObjects, [&](size_t) {
+		applyTransform(src, composed, queue.getTransform());
+	});
+	runKernel("TransformQueue per step", count, totalObjects, [&](size_t) {
+		applyTransform(src, stepped, steps[0].getTransform());
+		for (int i = 1; i < 4; i++) {
+			applyTransform(stepped, tmp, steps[i].getTransform());
+			std::swap(stepped, tmp);
+		}
+	});
+	std::printf("%-28s %8zu objs  max diff %g\n", "composed vs per step", count, maxDifference(composed, stepped));
+}
+
+// auto-fit: corners of 50k tilted objects
+void benchmarkMinAreaRect() {
+	std::mt19937 rng(17);
+	std::uniform_real_distribution<float> along(0.f, 20000.f), across(0.f, 600.f), size(10.f, 60.f);
+	const float angle = 0.3f;
+	const float c = std::cos(angle), s = std::sin(angle);
+	std::vector<Vec2> points;
+	for (int i = 0; i < 50'000; i++) {
+		const float u = along(rng), v = across(rng), w = size(rng);
+		for (const Vec2 corner : {Vec2{0, 0}, Vec2{w, 0}, Vec2{w, w}, Vec2{0, w}}) {
+			const Vec2 p = Vec2{u, v} + corner;
+			points.push_back({p.x * c - p.y * s, p.x * s + p.y * c});
+		}
+	}
+	auto time = [&](const char* name, WorkerPool* pool) {
+		const int repeats = 20;
+		OrientedRect rect;
+		size_t candidates = 0;
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < repeats; i++) {
+			candidates = filterHullCandidates(points, pool).size();
+			rect = computeMinAreaRect(points, pool);
+		}
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		std::printf("%-28s %8zu pts  %10.2f ms  (candidates: %zu, angle %.2f)\n", name, points.size(),
+			ms / repeats, candidates, rect.m_angle);
+	};
+	time("computeMinAreaRect", nullptr);
+	time("computeMinAreaRect (pool)", &WorkerPool::shared());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4'000'000;
+	const auto samples = makeSamples(1 << 16, 1337);
+
+	std::printf("iterations: %zu\n", iterations);
+
+	run("checkAnchorSnaps", samples, iterations, [](const Sample& s) {
+		Vec2 snap;
+		uint8_t indx = 0;
+		return checkAnchorSnaps(s.m_handles, s.m_rotation, s.m_limit, s.m_anchor, &snap, &indx, true);
+	});
+
+	run("checkAnchorIsOnEdge", samples, iterations, [](const Sample& s) {
+		uint8_t indx = 0;
+		return checkAnchorIsOnEdge(s.m_handles, s.m_rotation, s.m_limit, s.m_anchor, &indx);
+	});
+
+	// cached frame (same samples, the frame is rebuilt only when the sample changes,
+	// like during an anchor drag)
+	std::vector<TransformFrame> frames(samples.size());
+	for (size_t i = 0; i < samples.size(); i++) {
+		frames[i].rebuild(samples[i].m_handles, samples[i].m_rotation);
+	}
+	auto frameOf = [&](const Sample& s) -> const TransformFrame& { return frames[&s - samples.data()]; };
+
+	run("TransformFrame::rebuild", samples, iterations, [](const Sample& s) {
+		TransformFrame frame;
+		frame.rebuild(s.m_handles, s.m_rotation);
+		return frame.getVersion();
+	});
+
+	run("TransformFrame snaps", samples, iterations, [&](const Sample& s) {
+		Vec2 snap;
+		uint8_t indx = 0;
+		return frameOf(s).checkAnchorSnaps(s.m_limit, s.m_anchor, &snap, &indx, true);
+	});
+
+	run("TransformFrame onEdge", samples, iterations, [&](const Sample& s) {
+		uint8_t indx = 0;
+		return frameOf(s).checkAnchorIsOnEdge(s.m_limit, s.m_anchor, &indx);
+	});
+
+	// object snap grid: 100k objects spread over a typical level
+	{
+		std::mt19937 rng(42);
+		std::uniform_real_distribution<float> x(0.f, 60000.f), y(0.f, 3000.f), size(5.f, 120.f);
+		std::vector<Rect> objects(100'000);
+		for (auto& r : objects) {
+			r.m_min = {x(rng), y(rng)};
+			r.m_max = r.m_min + Vec2{size(rng), size(rng)};
+		}
+		SpatialGrid grid;
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < objects.size(); i++) grid.update((int)i, objects[i]);
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		std::printf("%-28s %10.2f ms for %zu objects\n", "SpatialGrid build", ms, objects.size());
+
+		std::vector<Sample> queries(samples.begin(), samples.end());
+		for (auto& q : queries) q.m_anchor = {x(rng), y(rng)};
+		run("SpatialGrid::queryNearest", queries, iterations, [&](const Sample& s) {
+			Vec2 snap;
+			int id;
+			return grid.queryNearest(s.m_anchor, s.m_limit, [](int) { return false; }, &snap, &id);
+		});
+		run("SpatialGrid::update (move)", samples, iterations / 4, [&, i = 0](const Sample& s) mutable {
+			const int id = i++ % (int)objects.size();
+			auto r = objects[id];
+			const Vec2 d = s.m_anchor / 100.f;
+			r.m_min = r.m_min + d;
+			r.m_max = r.m_max + d;
+			grid.update(id, r);
+			return true;
+		});
+	}
+
+	// angle histogram: 100k objects, most of them on a few slopes
+	{
+		std::mt19937 rng(7);
+		std::uniform_real_distribution<float> any(-180.f, 180.f);
+		const float slopes[] = {0.f, 30.f, 45.f, 22.5f, -60.f};
+		AngleHistogram histogram;
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < 100'000; i++) {
+			histogram.update(i, (rng() % 4) ? slopes[rng() % 5] + 90.f * (rng() % 4) : any(rng));
+		}
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		std::printf("%-28s %10.2f ms for %d objects (peaks:", "AngleHistogram build", ms, 100'000);
+		for (const float peak : histogram.getPeaks()) std::printf(" %.1f", peak);
+		std::printf(")\n");
+		run("AngleHistogram::snap", samples, iterations, [&](const Sample& s) {
+			float snapped;
+			return histogram.snap(s.m_rotation, &snapped);
+		});
+		run("AngleHistogram::update", samples, iterations / 4, [&, i = 0](const Sample& s) mutable {
+			// every update makes the next snap recompute the peaks
+			histogram.update(i++ % 100'000, s.m_rotation);
+			float snapped;
+			return histogram.snap(s.m_rotation + 1, &snapped);
+		});
+	}
+
+	// grid + guide snap: the cost shouldn't depend on the number of guides or the grid step
+	{
+		std::mt19937 rng(25);
+		std::uniform_real_distribution<float> x(0.f, 60000.f), y(0.f, 3000.f);
+		std::vector<Sample> queries(samples.begin(), samples.end());
+		for (auto& q : queries) q.m_anchor = {x(rng), y(rng)};
+		for (const int guideCount : {10, 100'000}) {
+			GuideLines guides;
+			for (int i = 0; i < guideCount; i++) {
+				guides.add(Vertical, x(rng), 0);
+				guides.add(Horizontal, y(rng), 0);
+			}
+			for (const float step : {GRID_SIZE, getGridStep(3)}) {
+				SnapLines lines{step, &guides};
+				char name[64];
+				std::snprintf(name, sizeof(name), "SnapLines %dg step %.2f", guideCount, step);
+				run(name, queries, iterations, [&](const Sample& s) {
+					Vec2 snap;
+					return lines.snapPoint(s.m_anchor, s.m_limit / 4, &snap) != 0;
+				});
+			}
+			SnapLines lines{GRID_SIZE, &guides};
+			char name[64];
+			std::snprintf(name, sizeof(name), "SnapLines %dg on line", guideCount);
+			run(name, queries, iterations, [&](const Sample& s) {
+				Vec2 snap;
+				const float rad = s.m_rotation * 3.14159265f / 180;
+				return lines.snapOnLine(s.m_anchor, {std::cos(rad), -std::sin(rad)}, s.m_limit / 4, &snap);
+			});
+		}
+	}
+
+	benchmarkKernels(iterations * 10);
+	benchmarkPivotKernels(iterations * 10);
+	benchmarkParallel(iterations * 10);
+	benchmarkQueue(iterations * 10);
+	benchmarkMinAreaRect();
+
+	return 0;
+}
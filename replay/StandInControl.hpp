@@ -0,0 +1,114 @@
+#pragma once
+#include "core/ControlLogic.hpp"
+#include "core/GestureRecording.hpp"
+#include "core/TransformFrame.hpp"
+
+// Headless stand-in for MyGJTransformControl. RobTop's part of every touch event is taken
+// from the recording, the mod's part goes through the same code as in the game
+// (see core/ControlLogic.hpp), so the result can be compared with the recorded one.
+// Object, common angle and grid snapping need the level, so their results are taken from the recording too
+class StandInControl {
+public:
+	void reset(const itc::GestureHeader& header) {
+		m_header = header;
+		m_rotation = header.m_rotation;
+		m_anchor = header.m_anchor;
+		m_handles = header.m_handles;
+		m_disabledSpritesSnap = header.m_disabledSpritesSnap;
+		m_disabledSpritesRot = header.m_disabledSpritesRot;
+		m_buttonType = 0;
+		m_frame.invalidate();
+	}
+
+	// process the touch event, returns it with the mod's results filled in
+	itc::GestureEvent process(const itc::GestureEvent& event) {
+		auto result = event;
+		// (handle snaps happen before RobTop's code, their result is in the recorded state)
+		result.m_flags &= itc::GestureEvent::ObjectSnapped | itc::GestureEvent::AngleSnapped
+			| itc::GestureEvent::LineSnapped | itc::GestureEvent::HandleSnapped;
+		switch (event.m_type) {
+			case itc::GestureEvent::Began:
+				m_buttonType = event.m_buttonType;
+				loadState(event);
+				break;
+			case itc::GestureEvent::Moved:
+				touchMoved(event, &result);
+				break;
+			case itc::GestureEvent::Ended:
+				loadState(event);
+				touchEnded();
+				break;
+			case itc::GestureEvent::Cancelled:
+				loadState(event);
+				break;
+		}
+		result.m_resultRotation = m_rotation;
+		result.m_resultAnchor = m_anchor;
+		result.m_resultDisabledSprites = getDisabledSprites();
+		return result;
+	}
+
+	uint16_t getDisabledSprites() const { return m_disabledSpritesSnap | m_disabledSpritesRot; }
+
+private:
+	itc::GestureHeader m_header;
+	float m_rotation = 0;
+	itc::Vec2 m_anchor;
+	itc::HandlePositions m_handles;
+	uint16_t m_disabledSpritesSnap = 0;
+	uint16_t m_disabledSpritesRot = 0;
+	uint8_t m_buttonType = 0;
+	itc::TransformFrame m_frame;
+
+	const itc::TransformFrame& getFrame() {
+		if (!m_frame.isValidFor(m_rotation)) m_frame.rebuild(m_handles, m_rotation);
+		return m_frame;
+	}
+
+	// state after RobTop's code
+	void loadState(const itc::GestureEvent& event) {
+		m_rotation = event.m_rotation;
+		m_anchor = event.m_anchor;
+		m_handles = event.m_handles;
+		m_frame.invalidate();
+	}
+
+	// see MyGJTransformControl::handleTouchMoved()
+	void touchMoved(const itc::GestureEvent& event, itc::GestureEvent* result) {
+		if (itc::isButtonDisabled(m_buttonType, getDisabledSprites())) return;
+		loadState(event);
+		const bool isSnap = m_header.hasFlag(itc::GestureHeader::Snap);
+
+		if (m_buttonType == 1 && isSnap) {
+			const float limit = itc::getAnchorSnapLimit(m_header.m_anchorScale);
+			uint8_t node;
+			itc::Vec2 snap;
+			if (getFrame().checkAnchorSnaps(limit, m_anchor, &snap, &node,
+					m_header.hasFlag(itc::GestureHeader::CenterSnap))) {
+				m_anchor = snap;
+				result->m_flags |= itc::GestureEvent::AnchorSnapped;
+				result->m_flags &= ~(itc::GestureEvent::ObjectSnapped | itc::GestureEvent::LineSnapped);
+			} else if (event.hasFlag(itc::GestureEvent::ObjectSnapped) || event.hasFlag(itc::GestureEvent::LineSnapped)) {
+				m_anchor = event.m_resultAnchor;
+			}
+		} else if (m_buttonType == 12 && isSnap) {
+			float snapped;
+			if (itc::snapRotation(m_rotation, &snapped)) {
+				m_rotation = snapped;
+				result->m_flags |= itc::GestureEvent::RotationSnapped;
+				result->m_flags &= ~itc::GestureEvent::AngleSnapped;
+			} else if (event.hasFlag(itc::GestureEvent::AngleSnapped)) {
+				m_rotation = event.m_resultRotation;
+			}
+		}
+	}
+
+	// see MyGJTransformControl::ccTouchEnded()
+	void touchEnded() {
+		const bool isAnchorSnap = m_buttonType == 1 && m_header.hasFlag(itc::GestureHeader::Snap);
+		const uint8_t node = itc::getAnchorReleaseNode(getFrame(), m_anchor,
+			itc::getAnchorSnapLimit(m_header.m_anchorScale), isAnchorSnap,
+			m_header.hasFlag(itc::GestureHeader::CenterSnap), itc::MAX_FP_ERROR);
+		m_disabledSpritesSnap = itc::getDisabledSpritesForNode(node);
+	}
+};
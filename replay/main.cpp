@@ -0,0 +1,207 @@
+// Replays recorded transform controls gestures (see core/GestureRecording.hpp) against the
+// headless stand-in control, checks the results and measures how long they take.
+// Build with -DITC_HEADLESS=ON (no Geode SDK needed):
+//   ITCReplay [--repeat N] file...    replay the recordings
+//   ITCReplay --synth file            write a synthetic recording
+//   ITCReplay                         replay the synthetic recording from memory
+// With -DITC_ALLOC_COUNTER=ON it also checks that the moves don't allocate on the heap
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "core/AllocCounter.hpp"
+#include "core/ControlLogic.hpp"
+#include "core/GestureRecording.hpp"
+#include "StandInControl.hpp"
+
+using namespace itc;
+
+namespace {
+
+// results are compared with some tolerance, the recording may come from another compiler
+constexpr float MAX_DIFFERENCE = 1e-3f;
+
+bool isClose(const Vec2 a, const Vec2 b) {
+	return std::abs(a.x - b.x) <= MAX_DIFFERENCE && std::abs(a.y - b.y) <= MAX_DIFFERENCE;
+}
+
+// rect w*h around the origin in m_mainNode coords
+HandlePositions makeRect(const float w, const float h) {
+	HandlePositions handles;
+	auto& p = handles.m_pos;
+	p[6] = {-w / 2, h / 2}; p[7] = {w / 2, h / 2};
+	p[8] = {-w / 2, -h / 2}; p[9] = {w / 2, -h / 2};
+	p[4] = (p[6] + p[7]) / 2.f; p[5] = (p[8] + p[9]) / 2.f;
+	p[2] = (p[6] + p[8]) / 2.f; p[3] = (p[7] + p[9]) / 2.f;
+	return handles;
+}
+
+// event of the synthetic recording: the state after RobTop's code and the result the mod
+// should give (worked out by hand, not by the stand-in control)
+struct SyntheticStep {
+	GestureEvent::Type m_type;
+	uint8_t m_button;
+	float m_rotation;
+	Vec2 m_anchor;
+	float m_resultRotation;
+	Vec2 m_resultAnchor;
+	uint16_t m_resultDisabled;
+	uint8_t m_flags;
+};
+
+// sprites aligned with the bottom right corner: 3 and 7 (same x), 5 and 8 (same y) and 9
+constexpr uint16_t CORNER_9_DISABLED = 0b001010111000;
+
+// Snap and center snap on, a 240x120 rect around the origin (corners at +-120, +-60),
+// anchor scale 1 (snap limit 18). First the rect is rotated (snaps to multiples of 90
+// within 2 degrees), then the anchor is dragged past the nodes and released on a corner,
+// then the (now disabled) corner handle is dragged
+GestureRecording makeSynthetic() {
+	using E = GestureEvent;
+	constexpr uint16_t C9 = CORNER_9_DISABLED;
+	static const SyntheticStep steps[] = {
+		// rotation: 88.6 rounds to 89 (1 from 90), 92.4 to 92, -178.9 to 179, -0.8 to 1
+		{E::Began, 12, 0, {0, 0}, 0, {0, 0}, 0, 0},
+		{E::Moved, 12, 45, {0, 0}, 45, {0, 0}, 0, 0},
+		{E::Moved, 12, 88.6f, {0, 0}, 90, {0, 0}, 0, E::RotationSnapped},
+		{E::Moved, 12, 92.4f, {0, 0}, 90, {0, 0}, 0, E::RotationSnapped},
+		{E::Moved, 12, 93, {0, 0}, 93, {0, 0}, 0, 0},
+		{E::Moved, 12, -178.9f, {0, 0}, -180, {0, 0}, 0, E::RotationSnapped},
+		{E::Moved, 12, -0.8f, {0, 0}, 0, {0, 0}, 0, E::RotationSnapped},
+		// the anchor is in the center, on no edge: nothing is disabled
+		{E::Ended, 12, 0, {0, 0}, 0, {0, 0}, 0, 0},
+		// anchor: (110, 55) is 11.2 from corner 7, (60, 30) is 67 from every node,
+		// (-5, 3) is 5.8 from the center, (118, -52) is 8.2 from corner 9
+		{E::Began, 1, 0, {0, 0}, 0, {0, 0}, 0, 0},
+		{E::Moved, 1, 0, {110, 55}, 0, {120, 60}, 0, E::AnchorSnapped},
+		{E::Moved, 1, 0, {60, 30}, 0, {60, 30}, 0, 0},
+		{E::Moved, 1, 0, {-5, 3}, 0, {0, 0}, 0, E::AnchorSnapped},
+		{E::Moved, 1, 0, {118, -52}, 0, {120, -60}, 0, E::AnchorSnapped},
+		{E::Ended, 1, 0, {120, -60}, 0, {120, -60}, C9, 0},
+		// corner 9 is disabled: its moves are ignored, the anchor stays where it was
+		{E::Began, 9, 0, {120, -60}, 0, {120, -60}, C9, 0},
+		{E::Moved, 9, 0, {100, -40}, 0, {120, -60}, C9, 0},
+		{E::Ended, 9, 0, {120, -60}, 0, {120, -60}, C9, 0},
+	};
+
+	GestureRecording rec;
+	auto& h = rec.m_header;
+	h.m_flags = GestureHeader::Snap | GestureHeader::CenterSnap;
+	h.m_selectionSize = 500;
+	h.m_handles = makeRect(240, 120);
+	float time = 0;
+	for (const auto& step : steps) {
+		GestureEvent event;
+		event.m_type = step.m_type;
+		event.m_buttonType = step.m_button;
+		event.m_flags = step.m_flags;
+		event.m_time = time;
+		time += 1 / 60.f;
+		event.m_touch = step.m_anchor;
+		event.m_rotation = step.m_rotation;
+		event.m_anchor = step.m_anchor;
+		event.m_handles = h.m_handles;
+		event.m_resultRotation = step.m_resultRotation;
+		event.m_resultAnchor = step.m_resultAnchor;
+		event.m_resultDisabledSprites = step.m_resultDisabled;
+		rec.m_events.push_back(event);
+	}
+	return rec;
+}
+
+// replay the recording, return the number of events with a different result.
+// Heap allocations of the moves are added to moveAllocations
+size_t replay(const GestureRecording& rec, const bool verbose, uint64_t* const moveAllocations = nullptr) {
+	StandInControl control;
+	control.reset(rec.m_header);
+	size_t mismatches = 0;
+	for (size_t i = 0; i < rec.m_events.size(); i++) {
+		const auto& expected = rec.m_events[i];
+		const uint64_t allocations = getAllocationCount();
+		const auto result = control.process(expected);
+		if (moveAllocations && expected.m_type == GestureEvent::Moved) {
+			*moveAllocations += getAllocationCount() - allocations;
+		}
+		const bool ok = isClose(result.m_resultAnchor, expected.m_resultAnchor)
+			&& std::abs(result.m_resultRotation - expected.m_resultRotation) <= MAX_DIFFERENCE
+			&& result.m_resultDisabledSprites == expected.m_resultDisabledSprites
+			&& result.m_flags == expected.m_flags;
+		if (ok) continue;
+		mismatches++;
+		if (verbose && mismatches <= 10) {
+			std::printf("  event %zu (type %d, button %d): anchor (%.3f, %.3f) expected (%.3f, %.3f), "
+				"rotation %.3f expected %.3f, disabled %03x expected %03x, flags %x expected %x\n",
+				i, expected.m_type, expected.m_buttonType,
+				result.m_resultAnchor.x, result.m_resultAnchor.y,
+				expected.m_resultAnchor.x, expected.m_resultAnchor.y,
+				result.m_resultRotation, expected.m_resultRotation,
+				result.m_resultDisabledSprites, expected.m_resultDisabledSprites,
+				result.m_flags, expected.m_flags);
+		}
+	}
+	return mismatches;
+}
+
+// replay + time it, return false if the results don't match
+bool run(const char* name, const GestureRecording& rec, const int repeat) {
+	const size_t mismatches = replay(rec, true);
+	uint64_t moveAllocations = 0;
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < repeat; i++) replay(rec, false, &moveAllocations);
+	const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	const double events = (double)rec.m_events.size() * repeat;
+	std::printf("%-32s %6zu events  %8.1f ns/event  %s\n", name, rec.m_events.size(),
+		events > 0 ? ns / events : 0.0, mismatches == 0 ? "ok" : "MISMATCH");
+	if (mismatches) std::printf("  %zu events differ\n", mismatches);
+	if (isAllocationCounterEnabled()) {
+		std::printf("  %llu heap allocations in the moves\n", (unsigned long long)moveAllocations);
+	}
+	return mismatches == 0 && moveAllocations == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	int repeat = 1000;
+	std::vector<const char*> files;
+	for (int i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+			repeat = std::max(1, std::atoi(argv[++i]));
+		} else if (std::strcmp(argv[i], "--synth") == 0 && i + 1 < argc) {
+			if (!makeSynthetic().save(argv[++i])) {
+				std::printf("can't write %s\n", argv[i]);
+				return 1;
+			}
+			return 0;
+		} else {
+			files.push_back(argv[i]);
+		}
+	}
+
+	bool ok = true;
+	if (files.empty()) {
+		// goes through the file format too
+		GestureRecording rec;
+		const auto data = makeSynthetic().serialize();
+		if (!GestureRecording::deserialize(data.data(), data.size(), &rec)) {
+			std::printf("synthetic recording doesn't deserialize\n");
+			return 1;
+		}
+		ok = run("synthetic", rec, repeat);
+	}
+	for (const auto file : files) {
+		GestureRecording rec;
+		if (!GestureRecording::load(file, &rec)) {
+			std::printf("%s: not a gesture recording\n", file);
+			ok = false;
+			continue;
+		}
+		ok &= run(file, rec, repeat);
+	}
+	return ok ? 0 : 1;
+}
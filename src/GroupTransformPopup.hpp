@@ -0,0 +1,101 @@
+#pragma once
+#include <functional>
+#include <Geode/Geode.hpp>
+
+// transform of all the objects of a group ID (see MyEditorUI::transformGroup()).
+// Applied in this order, about the center of the group bounds
+struct GroupTransform {
+	int m_groupID = 0;
+	float m_rotation = 0; // clockwise, in degrees
+	float m_scale = 1;
+	bool m_flipX = false;
+	bool m_flipY = false;
+};
+
+// Popup of the "Group" button of the transform controls: the group ID and the operations.
+// "Apply" passes them to the callback, the popup stays open for the next one
+class GroupTransformPopup : public geode::Popup<std::function<void(const GroupTransform&)>> {
+private:
+	std::function<void(const GroupTransform&)> m_callback;
+	geode::TextInput* m_groupInput = nullptr;
+	geode::TextInput* m_rotationInput = nullptr;
+	geode::TextInput* m_scaleInput = nullptr;
+	CCMenuItemToggler* m_flipXToggle = nullptr;
+	CCMenuItemToggler* m_flipYToggle = nullptr;
+	// last group the popup was used for
+	static inline int s_groupID = 0;
+
+public:
+	static GroupTransformPopup* create(std::function<void(const GroupTransform&)> callback) {
+		auto ret = new GroupTransformPopup();
+		if (ret && ret->initAnchored(240, 200, std::move(callback))) {
+			ret->autorelease();
+			return ret;
+		}
+		CC_SAFE_DELETE(ret);
+		return nullptr;
+	}
+
+protected:
+	bool setup(std::function<void(const GroupTransform&)> callback) override {
+		m_callback = std::move(callback);
+		this->setTitle("Transform group");
+		this->setID("razoom.improved-transform-control.group-popup");
+
+		m_groupInput = addInput("Group ID", 35, geode::CommonFilter::Uint);
+		if (s_groupID > 0) m_groupInput->setString(std::to_string(s_groupID));
+		m_rotationInput = addInput("Rotation", 5, geode::CommonFilter::Float);
+		m_scaleInput = addInput("Scale", -25, geode::CommonFilter::Float);
+
+		m_flipXToggle = addToggle("Flip X", -55);
+		m_flipYToggle = addToggle("Flip Y", 55);
+
+		auto applySpr = ButtonSprite::create("Apply", "goldFont.fnt", "GJ_button_01.png", .8f);
+		auto applyBtn = CCMenuItemSpriteExtra::create(applySpr, this, menu_selector(GroupTransformPopup::onApply));
+		m_buttonMenu->addChildAtPosition(applyBtn, geode::Anchor::Bottom, ccp(0, 25));
+		return true;
+	}
+
+	geode::TextInput* addInput(const char* name, float y, geode::CommonFilter filter) {
+		auto label = CCLabelBMFont::create(name, "bigFont.fnt");
+		label->setScale(.4f);
+		label->setAnchorPoint(ccp(0, .5f));
+		m_mainLayer->addChildAtPosition(label, geode::Anchor::Center, ccp(-100, y));
+		auto input = geode::TextInput::create(80, "", "bigFont.fnt");
+		input->setCommonFilter(filter);
+		input->setScale(.8f);
+		m_mainLayer->addChildAtPosition(input, geode::Anchor::Center, ccp(55, y));
+		return input;
+	}
+
+	CCMenuItemToggler* addToggle(const char* name, float x) {
+		auto toggle = CCMenuItemToggler::createWithStandardSprites(this, nullptr, .6f);
+		m_buttonMenu->addChildAtPosition(toggle, geode::Anchor::Center, ccp(x - 25, -55));
+		auto label = CCLabelBMFont::create(name, "bigFont.fnt");
+		label->setScale(.35f);
+		label->setAnchorPoint(ccp(0, .5f));
+		m_mainLayer->addChildAtPosition(label, geode::Anchor::Center, ccp(x - 10, -55));
+		return toggle;
+	}
+
+	// empty or invalid inputs keep the default
+	template <class T>
+	static T getValue(geode::TextInput* input, T fallback) {
+		return geode::utils::numFromString<T>(input->getString()).unwrapOr(fallback);
+	}
+
+	void onApply(CCObject*) {
+		GroupTransform transform;
+		transform.m_groupID = getValue<int>(m_groupInput, 0);
+		transform.m_rotation = getValue<float>(m_rotationInput, 0);
+		transform.m_scale = getValue<float>(m_scaleInput, 1);
+		transform.m_flipX = m_flipXToggle->isToggled();
+		transform.m_flipY = m_flipYToggle->isToggled();
+		if (transform.m_groupID <= 0) {
+			geode::Notification::create("Enter a group ID", geode::NotificationIcon::Warning)->show();
+			return;
+		}
+		s_groupID = transform.m_groupID;
+		m_callback(transform);
+	}
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include <Geode/Geode.hpp>
+#include "core/SnapLines.hpp"
+#include "LineBatch.hpp"
+#include "SelectionProxy.hpp"
+
+// Guide lines the anchor and the handles snap to, drawn across the visible part of the
+// level. Only the guides in the view are added (found by a binary search) and the batch
+// is rebuilt only when the guides changed or the view moved.
+// Must be added to the object layer (uses its coords)
+class GuideOverlay : public cocos2d::CCNode {
+private:
+	const itc::GuideLines* m_guides = nullptr;
+	LineBatch m_batch;
+	cocos2d::ccColor4B m_color = {255, 255, 255, 255};
+	uint32_t m_version = 0;
+	itc::Rect m_visibleRect;
+
+public:
+	static GuideOverlay* create(const itc::GuideLines* guides) {
+		auto ret = new GuideOverlay();
+		if (ret && ret->init(guides)) {
+			ret->autorelease();
+			return ret;
+		}
+		CC_SAFE_DELETE(ret);
+		return nullptr;
+	}
+
+	bool init(const itc::GuideLines* guides) {
+		if (!CCNode::init()) return false;
+		m_guides = guides;
+		m_version = guides->getVersion() - 1;
+		this->setID("razoom.improved-transform-control.guides");
+		return true;
+	}
+
+	void setColor(const cocos2d::ccColor4B& col) {
+		m_color = col;
+	}
+
+	void draw() override {
+		if (m_guides->empty()) return;
+		const auto visible = getVisibleRect(this);
+		if (m_version != m_guides->getVersion() || !(visible == m_visibleRect)) {
+			m_version = m_guides->getVersion();
+			m_visibleRect = visible;
+			m_batch.clear();
+			const auto [x0, x1] = m_guides->getRange(itc::Vertical, visible.m_min.x, visible.m_max.x);
+			for (auto x = x0; x != x1; x++) {
+				m_batch.addLine(ccp(*x, visible.m_min.y), ccp(*x, visible.m_max.y));
+			}
+			const auto [y0, y1] = m_guides->getRange(itc::Horizontal, visible.m_min.y, visible.m_max.y);
+			for (auto y = y0; y != y1; y++) {
+				m_batch.addLine(ccp(visible.m_min.x, *y), ccp(visible.m_max.x, *y));
+			}
+		}
+		m_batch.draw(m_color);
+	}
+};
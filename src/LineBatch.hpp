@@ -0,0 +1,53 @@
+#pragma once
+#include <vector>
+#include <Geode/Geode.hpp>
+
+// Retained vertex buffer of line segments that is submitted with one draw call.
+// (unlike ccDrawLine() / ccDrawRect() which set up GL state for every primitive)
+class LineBatch {
+private:
+	std::vector<cocos2d::ccVertex2F> m_vertices;
+
+public:
+	void clear() { m_vertices.clear(); }
+	bool empty() const { return m_vertices.empty(); }
+	size_t size() const { return m_vertices.size() / 2; }
+	void reserve(size_t lines) { m_vertices.reserve(lines * 2); }
+
+	void addLine(const cocos2d::CCPoint& a, const cocos2d::CCPoint& b) {
+		m_vertices.push_back({a.x, a.y});
+		m_vertices.push_back({b.x, b.y});
+	}
+
+	// same as ccDrawRect()
+	void addRect(const cocos2d::CCPoint& origin, const cocos2d::CCPoint& dest) {
+		addLine(origin, ccp(dest.x, origin.y));
+		addLine(ccp(dest.x, origin.y), dest);
+		addLine(dest, ccp(origin.x, dest.y));
+		addLine(ccp(origin.x, dest.y), origin);
+	}
+
+	// closed polygon
+	void addPoly(const cocos2d::CCPoint* points, size_t count) {
+		if (count < 2) return;
+		for (size_t A = count - 1, B = 0; B < count; A = B++) {
+			addLine(points[A], points[B]);
+		}
+	}
+
+	void draw(const cocos2d::ccColor4B& col) const {
+		using namespace cocos2d;
+		if (m_vertices.empty()) return;
+		auto shader = CCShaderCache::sharedShaderCache()->programForKey(kCCShader_Position_uColor);
+		// not cached: the program is recreated when GL context is lost (android)
+		const GLint colorLocation = glGetUniformLocation(shader->getProgram(), "u_color");
+		shader->use();
+		shader->setUniformsForBuiltins();
+		shader->setUniformLocationWith4f(colorLocation,
+			col.r / 255.f, col.g / 255.f, col.b / 255.f, col.a / 255.f);
+		ccGLEnableVertexAttribs(kCCVertexAttribFlag_Position);
+		glVertexAttribPointer(kCCVertexAttrib_Position, 2, GL_FLOAT, GL_FALSE, 0, m_vertices.data());
+		glDrawArrays(GL_LINES, 0, (GLsizei)m_vertices.size());
+		CC_INCREMENT_GL_DRAWS(1);
+	}
+};
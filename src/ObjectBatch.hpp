@@ -0,0 +1,141 @@
+#pragma once
+#include <vector>
+#include <Geode/Geode.hpp>
+#include "core/TransformKernel.hpp"
+#include "core/WorkerPool.hpp"
+#include "TransformArgs.hpp"
+
+// Transform of a big selection without going through RobTop's per object code:
+// the state of the objects is gathered once into a structure-of-arrays buffer,
+// every transform is computed from it with the vectorized kernel and written back.
+class ObjectBatch {
+public:
+	// below this the threads cost more than they save
+	static constexpr size_t PARALLEL_MIN_OBJECTS = 16384;
+
+	// what every object is rotated / scaled about
+	enum class Pivot {
+		Shared, // the anchor of the transform
+		Center, // center of the object bounds
+		BottomLeft,
+		BottomRight,
+		TopLeft,
+		TopRight,
+	};
+
+private:
+	geode::Ref<cocos2d::CCArray> m_objs;
+	itc::ObjectBuffer m_start;  // state of the objects when they were gathered
+	itc::ObjectBuffer m_result;
+	TransformArgs m_baseArgs;   // transform that had been applied when the objects were gathered
+	Pivot m_pivot = Pivot::Shared;
+	std::vector<float> m_pivotX, m_pivotY; // own pivots of the objects (see itc::applyPivotTransformSimd())
+	bool m_flipX = false, m_flipY = false; // the result is mirrored (see itc::ObjectTransform)
+	bool m_isScattering = false;
+
+public:
+	// only checks the array and the count: the owner must reset the batch when the objects
+	// in the array change (selection changes, RobTop's own edits)
+	bool isGatheredFrom(cocos2d::CCArray* objs, const Pivot pivot = Pivot::Shared) const {
+		return m_objs == objs && m_start.size() == objs->count() && m_pivot == pivot;
+	}
+	bool isScattering() const { return m_isScattering; }
+	size_t size() const { return m_start.size(); }
+
+	void reset() {
+		m_objs = nullptr;
+		m_start.clear();
+	}
+
+	void gather(cocos2d::CCArray* objs, const TransformArgs& baseArgs, const Pivot pivot = Pivot::Shared) {
+		m_objs = objs;
+		m_baseArgs = baseArgs;
+		m_pivot = pivot;
+		const size_t count = objs->count();
+		m_start.resize(count);
+		m_result.resize(count);
+		m_pivotX.resize(pivot == Pivot::Shared ? 0 : count);
+		m_pivotY.resize(pivot == Pivot::Shared ? 0 : count);
+		size_t i = 0;
+		for (auto obj : geode::cocos::CCArrayExt<GameObject*>(objs)) {
+			const auto pos = obj->getPosition();
+			m_start.m_x[i] = pos.x;
+			m_start.m_y[i] = pos.y;
+			m_start.m_rotX[i] = obj->getRotationX();
+			m_start.m_rotY[i] = obj->getRotationY();
+			m_start.m_scaleX[i] = obj->m_scaleX;
+			m_start.m_scaleY[i] = obj->m_scaleY;
+			if (pivot != Pivot::Shared) {
+				const auto p = getPivot(obj->getObjectRect(), pivot);
+				m_pivotX[i] = p.x;
+				m_pivotY[i] = p.y;
+			}
+			i++;
+		}
+	}
+
+	static cocos2d::CCPoint getPivot(const cocos2d::CCRect& rect, const Pivot pivot) {
+		switch (pivot) {
+			case Pivot::BottomLeft: return ccp(rect.getMinX(), rect.getMinY());
+			case Pivot::BottomRight: return ccp(rect.getMaxX(), rect.getMinY());
+			case Pivot::TopLeft: return ccp(rect.getMinX(), rect.getMaxY());
+			case Pivot::TopRight: return ccp(rect.getMaxX(), rect.getMaxY());
+			default: return ccp(rect.getMidX(), rect.getMidY());
+		}
+	}
+
+	// compute the state of the objects after args (args must be rigid, see TransformArgs).
+	// Only reads and writes the buffers, so big selections are split across the cores.
+	// With own pivots, only the rotation / scale of the transform is applied (about them):
+	// the anchor of the controls doesn't move the objects
+	void apply(const TransformArgs& args) {
+		const auto transform = args.relativeTo(m_baseArgs);
+		if (m_pivot == Pivot::Shared) {
+			apply(transform);
+			return;
+		}
+		const itc::Vec2 move = {0, 0};
+		m_flipX = transform.m_flipX;
+		m_flipY = transform.m_flipY;
+		if (m_start.size() >= PARALLEL_MIN_OBJECTS) {
+			itc::applyPivotTransformParallel(m_start, m_pivotX.data(), m_pivotY.data(), m_result,
+				transform, move, itc::WorkerPool::shared());
+		} else {
+			itc::applyPivotTransformSimd(m_start, m_pivotX.data(), m_pivotY.data(), m_result,
+				transform, move, 0, m_start.size());
+		}
+	}
+
+	// compute the state of the objects after the transform
+	void apply(const itc::ObjectTransform& transform) {
+		m_flipX = transform.m_flipX;
+		m_flipY = transform.m_flipY;
+		if (m_start.size() >= PARALLEL_MIN_OBJECTS) {
+			itc::applyTransformParallel(m_start, m_result, transform, itc::WorkerPool::shared());
+		} else {
+			itc::applyTransform(m_start, m_result, transform);
+		}
+	}
+
+	// write the result back to the objects (main thread only)
+	void scatter(EditorUI* editor) {
+		m_isScattering = true;
+		size_t i = 0;
+		for (auto obj : geode::cocos::CCArrayExt<GameObject*>(m_objs)) {
+			const auto pos = ccp(m_result.m_x[i], m_result.m_y[i]);
+			editor->moveObject(obj, pos - obj->getPosition());
+			if (m_result.m_rotX[i] == m_result.m_rotY[i]) {
+				obj->setRotation(m_result.m_rotX[i]);
+			} else {
+				obj->setRotationX(m_result.m_rotX[i]);
+				obj->setRotationY(m_result.m_rotY[i]);
+			}
+			obj->updateCustomScaleX(m_result.m_scaleX[i]);
+			obj->updateCustomScaleY(m_result.m_scaleY[i]);
+			if (m_flipX) obj->setFlipX(!obj->isFlipX());
+			if (m_flipY) obj->setFlipY(!obj->isFlipY());
+			i++;
+		}
+		m_isScattering = false;
+	}
+};
@@ -0,0 +1,76 @@
+#pragma once
+#include <algorithm>
+#include <Geode/Geode.hpp>
+#include "core/ScratchArena.hpp"
+
+// Section reordering of a big transform in one pass: while the batch is open, the objects
+// RobTop reorders (see MyGJBaseGameLayer) are only collected. When it's closed, the new
+// section of every collected object is computed with the game's sectionForPos() and
+// compared to the one it's in (m_outerSectionIndex / m_middleSectionIndex). Only the
+// objects whose section changed are reordered, sorted by the destination section.
+// Batches can be nested, the outer one collects the objects.
+// Objects aren't retained, they must stay in the level while the batch is open.
+// Memory comes from the gesture arena (see core/ScratchArena.hpp)
+class SectionBatch {
+private:
+	// object that goes to another section
+	struct Move {
+		GameObject* m_obj;
+		int m_sectionX, m_sectionY; // destination
+	};
+
+	static inline SectionBatch* s_open = nullptr;
+	GJBaseGameLayer* m_layer;
+	// everything the batch allocates is given back when it's closed (batches are also
+	// opened outside of gestures, e.g. by undo)
+	itc::ScratchArena::Mark m_mark;
+	itc::ArenaVector<GameObject*> m_objs;
+
+public:
+	explicit SectionBatch(GJBaseGameLayer* layer)
+		: m_layer(layer), m_mark(itc::ScratchArena::gesture().getMark()),
+		m_objs(itc::ArenaAllocator<GameObject*>(itc::ScratchArena::gesture())) {
+		if (!s_open) s_open = this;
+	}
+	~SectionBatch() {
+		if (s_open != this) return;
+		s_open = nullptr;
+		flush();
+		itc::ScratchArena::gesture().rewind(m_mark);
+	}
+	SectionBatch(const SectionBatch&) = delete;
+	SectionBatch& operator=(const SectionBatch&) = delete;
+
+	// returns false if there's no open batch (the object must be reordered right away)
+	static bool defer(GameObject* obj) {
+		if (!s_open) return false;
+		s_open->m_objs.push_back(obj);
+		return true;
+	}
+
+private:
+	void flush() {
+		if (m_objs.empty()) return;
+		// an object can be reordered several times during the transform
+		std::sort(m_objs.begin(), m_objs.end());
+		m_objs.erase(std::unique(m_objs.begin(), m_objs.end()), m_objs.end());
+
+		itc::ArenaVector<Move> moves{itc::ArenaAllocator<Move>(itc::ScratchArena::gesture())};
+		moves.reserve(m_objs.size());
+		for (auto obj : m_objs) {
+			const auto pos = obj->getPosition();
+			const int sectionX = GJBaseGameLayer::sectionForPos(pos.x);
+			const int sectionY = GJBaseGameLayer::sectionForPos(pos.y);
+			if (sectionX == obj->m_outerSectionIndex && sectionY == obj->m_middleSectionIndex) continue;
+			moves.push_back({obj, sectionX, sectionY});
+		}
+		// the objects of one section go one after another
+		std::sort(moves.begin(), moves.end(), [](const Move& a, const Move& b) {
+			return a.m_sectionX != b.m_sectionX ? a.m_sectionX < b.m_sectionX : a.m_sectionY < b.m_sectionY;
+		});
+		for (const auto& move : moves) {
+			m_layer->reorderObjectSection(move.m_obj);
+		}
+		m_objs.clear();
+	}
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <Geode/Geode.hpp>
+#include "LineBatch.hpp"
+#include "SelectionProxy.hpp"
+
+// Oriented bounds of every selected object, shown during the transform (so you can see
+// which objects are going to overlap). Only the objects in the visible part of the level
+// are outlined, and all the outlines are drawn with one LineBatch. The batch is rebuilt
+// only when the objects were transformed or the view moved.
+// Must be added to the object layer (uses its coords)
+class SelectionOutlines : public cocos2d::CCNode {
+private:
+	geode::Ref<cocos2d::CCArray> m_objs;
+	LineBatch m_batch;
+	cocos2d::ccColor4B m_color = {255, 255, 255, 255};
+	bool m_dirty = false;
+	itc::Rect m_visibleRect;
+
+public:
+	static SelectionOutlines* create() {
+		auto ret = new SelectionOutlines();
+		if (ret && ret->init()) {
+			ret->autorelease();
+			return ret;
+		}
+		CC_SAFE_DELETE(ret);
+		return nullptr;
+	}
+
+	bool init() override {
+		if (!CCNode::init()) return false;
+		this->setID("razoom.improved-transform-control.selection-outlines");
+		return true;
+	}
+
+	void setObjects(cocos2d::CCArray* objs) {
+		m_objs = objs;
+		m_dirty = true;
+	}
+
+	void clear() {
+		m_objs = nullptr;
+		m_batch.clear();
+		m_dirty = false;
+	}
+
+	void setColor(const cocos2d::ccColor4B& col) {
+		m_color = col;
+	}
+
+	// the objects were transformed
+	void setDirty() {
+		m_dirty = true;
+	}
+
+	void draw() override {
+		if (!m_objs) return;
+		const auto visible = getVisibleRect(this);
+		if (m_dirty || !(visible == m_visibleRect)) {
+			m_visibleRect = visible;
+			m_batch.clear();
+			for (auto obj : geode::cocos::CCArrayExt<cocos2d::CCNode*>(m_objs)) {
+				// cheap check first: the object can't reach further than its size from its position
+				const auto pos = obj->getPosition();
+				const auto size = obj->getContentSize();
+				const float reach = (size.width + size.height)
+					* std::max(std::abs(obj->getScaleX()), std::abs(obj->getScaleY()));
+				if (!visible.expanded(reach).intersects({{pos.x, pos.y}, {pos.x, pos.y}})) continue;
+
+				itc::Vec2 corners[4];
+				getObjectCorners(obj, corners);
+				if (!getQuadBounds(corners).intersects(visible)) continue;
+				cocos2d::CCPoint p[4];
+				for (int k = 0; k < 4; k++) p[k] = ccp(corners[k].x, corners[k].y);
+				m_batch.addPoly(p, 4);
+			}
+			m_dirty = false;
+		}
+		m_batch.draw(m_color);
+	}
+};
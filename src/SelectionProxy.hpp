@@ -0,0 +1,121 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include <Geode/Geode.hpp>
+#include "core/Affine.hpp"
+#include "LineBatch.hpp"
+
+// axis aligned bounds of the quad
+inline itc::Rect getQuadBounds(const itc::Vec2 (&v)[4]) {
+	return {{std::min(std::min(v[0].x, v[1].x), std::min(v[2].x, v[3].x)),
+			std::min(std::min(v[0].y, v[1].y), std::min(v[2].y, v[3].y))},
+		{std::max(std::max(v[0].x, v[1].x), std::max(v[2].x, v[3].x)),
+			std::max(std::max(v[0].y, v[1].y), std::max(v[2].y, v[3].y))}};
+}
+
+// oriented corners of the object (in the object layer coords)
+inline void getObjectCorners(cocos2d::CCNode* obj, itc::Vec2 (&corners)[4]) {
+	const auto size = obj->getContentSize();
+	const auto t = obj->nodeToParentTransform();
+	const itc::Affine m = {t.a, t.b, t.c, t.d, t.tx, t.ty};
+	corners[0] = m.apply({0, 0});
+	corners[1] = m.apply({size.width, 0});
+	corners[2] = m.apply({size.width, size.height});
+	corners[3] = m.apply({0, size.height});
+}
+
+// part of the screen that is visible in the node's coords (bounds of the screen corners)
+inline itc::Rect getVisibleRect(cocos2d::CCNode* node) {
+	const auto size = cocos2d::CCDirector::sharedDirector()->getWinSize();
+	itc::Rect rect;
+	int i = 0;
+	for (const auto corner : {ccp(0, 0), ccp(size.width, 0), ccp(size.width, size.height), ccp(0, size.height)}) {
+		const auto p = node->convertToNodeSpace(corner);
+		const itc::Vec2 v = {p.x, p.y};
+		if (i++ == 0) {
+			rect = {v, v};
+			continue;
+		}
+		rect.m_min = {std::min(rect.m_min.x, v.x), std::min(rect.m_min.y, v.y)};
+		rect.m_max = {std::max(rect.m_max.x, v.x), std::max(rect.m_max.y, v.y)};
+	}
+	return rect;
+}
+
+// Lightweight "ghost" of the selection: outlines of the selected objects that are
+// transformed during the gesture instead of the objects themselves.
+// Must be added to the object layer (uses its coords)
+class SelectionProxy : public cocos2d::CCNode {
+private:
+	std::vector<itc::Vec2> m_corners; // 4 per object, state before the transform
+	itc::Affine m_transform;
+	LineBatch m_batch;
+	cocos2d::ccColor4B m_color = {255, 255, 255, 255};
+	bool m_dirty = false;
+	itc::Rect m_visibleRect; // only the outlines inside it are in the batch
+
+public:
+	static SelectionProxy* create() {
+		auto ret = new SelectionProxy();
+		if (ret && ret->init()) {
+			ret->autorelease();
+			return ret;
+		}
+		CC_SAFE_DELETE(ret);
+		return nullptr;
+	}
+
+	bool init() override {
+		if (!CCNode::init()) return false;
+		this->setID("razoom.improved-transform-control.selection-proxy");
+		return true;
+	}
+
+	// remember the current state of the objects
+	void snapshot(cocos2d::CCArray* objs) {
+		m_corners.clear();
+		m_corners.reserve(objs->count() * 4);
+		for (auto obj : geode::cocos::CCArrayExt<cocos2d::CCNode*>(objs)) {
+			itc::Vec2 corners[4];
+			getObjectCorners(obj, corners);
+			m_corners.insert(m_corners.end(), std::begin(corners), std::end(corners));
+		}
+		m_batch.reserve(m_corners.size());
+		m_transform = {};
+		m_dirty = true;
+	}
+
+	void clear() {
+		m_corners.clear();
+		m_batch.clear();
+		m_dirty = false;
+	}
+
+	void setColor(const cocos2d::ccColor4B& col) {
+		m_color = col;
+	}
+
+	// transform of the snapshot that is shown
+	void setTransform(const itc::Affine& transform) {
+		m_transform = transform;
+		m_dirty = true;
+	}
+
+	void draw() override {
+		const auto visible = getVisibleRect(this);
+		if (m_dirty || !(visible == m_visibleRect)) {
+			m_visibleRect = visible;
+			m_batch.clear();
+			for (size_t i = 0; i + 3 < m_corners.size(); i += 4) {
+				itc::Vec2 v[4];
+				for (int k = 0; k < 4; k++) v[k] = m_transform.apply(m_corners[i + k]);
+				if (!getQuadBounds(v).intersects(visible)) continue;
+				cocos2d::CCPoint p[4];
+				for (int k = 0; k < 4; k++) p[k] = ccp(v[k].x, v[k].y);
+				m_batch.addPoly(p, 4);
+			}
+			m_dirty = false;
+		}
+		m_batch.draw(m_color);
+	}
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include <Geode/Geode.hpp>
+#include "core/Affine.hpp"
+#include "core/TransformKernel.hpp"
+
+// arguments of EditorUI::transformObjects().
+// They are cumulative: relative to the state of the objects when the transform
+// controls were activated
+struct TransformArgs {
+	cocos2d::CCPoint m_anchor;
+	float m_scaleX = 1, m_scaleY = 1;
+	float m_rotX = 0, m_rotY = 0;
+	float m_warpX = 0, m_warpY = 0;
+
+	itc::Affine toAffine() const {
+		return itc::makeControlTransform({m_anchor.x, m_anchor.y},
+			m_scaleX, m_scaleY, m_rotX, m_rotY, m_warpX, m_warpY);
+	}
+
+	// can the change of every object be described by itc::ObjectTransform
+	// (rotation and uniform scale, no warp)
+	bool isRigid() const {
+		return m_warpX == 0 && m_warpY == 0 && m_rotX == m_rotY && m_scaleX == m_scaleY && m_scaleX != 0;
+	}
+
+	// change of the objects from the state after base to the state after this
+	itc::ObjectTransform relativeTo(const TransformArgs& base) const {
+		itc::ObjectTransform ret;
+		ret.m_matrix = toAffine() * base.toAffine().inverse();
+		ret.m_rotX = m_rotX - base.m_rotX;
+		ret.m_rotY = m_rotY - base.m_rotY;
+		ret.m_scaleX = m_scaleX / base.m_scaleX;
+		ret.m_scaleY = m_scaleY / base.m_scaleY;
+		return ret;
+	}
+};
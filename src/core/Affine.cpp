@@ -0,0 +1,38 @@
+#include "Affine.hpp"
+#include <cmath>
+
+namespace itc {
+
+constexpr double DEG_TO_RAD = 3.14159265358979323846 / 180.0;
+
+Affine Affine::inverse() const {
+	const float det = determinant();
+	if (det == 0) return {}; // degenerate, nothing sensible to return
+	const float inv = 1.f / det;
+	return {
+		d * inv, -b * inv,
+		-c * inv, a * inv,
+		(c * ty - d * tx) * inv, (b * tx - a * ty) * inv,
+	};
+}
+
+Affine Affine::rotation(const float degrees) {
+	const float rad = float(-degrees * DEG_TO_RAD);
+	const float cos = std::cos(rad), sin = std::sin(rad);
+	return {cos, sin, -sin, cos, 0, 0};
+}
+
+Affine makeControlTransform(const Vec2 anchor, const float scaleX, const float scaleY,
+							const float rotX, const float rotY, const float warpX, const float warpY) {
+	// see CCNode::nodeToParentTransform()
+	const double radX = -rotX * DEG_TO_RAD;
+	const double radY = -rotY * DEG_TO_RAD;
+	const float cx = float(std::cos(radX)), sx = float(std::sin(radX));
+	const float cy = float(std::cos(radY)), sy = float(std::sin(radY));
+	const Affine rotScale = {cy * scaleX, sy * scaleX, -sx * scaleY, cx * scaleY, 0, 0};
+	if (warpX == 0 && warpY == 0) return rotScale.about(anchor);
+	const Affine skew = {1, float(std::tan(warpY * DEG_TO_RAD)), float(std::tan(warpX * DEG_TO_RAD)), 1, 0, 0};
+	return (rotScale * skew).about(anchor);
+}
+
+} // namespace itc
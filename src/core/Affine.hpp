@@ -0,0 +1,44 @@
+#pragma once
+#include "Geometry.hpp"
+
+namespace itc {
+
+// 2d affine transform, same layout as CCAffineTransform:
+// x' = a*x + c*y + tx
+// y' = b*x + d*y + ty
+struct Affine {
+	float a = 1, b = 0, c = 0, d = 1;
+	float tx = 0, ty = 0;
+
+	constexpr Vec2 apply(const Vec2 p) const { return {a * p.x + c * p.y + tx, b * p.x + d * p.y + ty}; }
+	// apply without translation
+	constexpr Vec2 applyLinear(const Vec2 p) const { return {a * p.x + c * p.y, b * p.x + d * p.y}; }
+
+	// (this * o)(p) == this(o(p)) - i.e. o is applied first
+	constexpr Affine operator*(const Affine& o) const {
+		return {
+			a * o.a + c * o.b, b * o.a + d * o.b,
+			a * o.c + c * o.d, b * o.c + d * o.d,
+			a * o.tx + c * o.ty + tx, b * o.tx + d * o.ty + ty,
+		};
+	}
+
+	constexpr float determinant() const { return a * d - b * c; }
+	Affine inverse() const;
+
+	static constexpr Affine translation(const Vec2 t) { return {1, 0, 0, 1, t.x, t.y}; }
+	// clockwise rotation in degrees (cocos style)
+	static Affine rotation(const float degrees);
+	static constexpr Affine scale(const float sx, const float sy) { return {sx, 0, 0, sy, 0, 0}; }
+
+	// make the transform act around the pivot instead of (0,0)
+	Affine about(const Vec2 pivot) const { return translation(pivot) * (*this) * translation(pivot * -1.f); }
+};
+
+// Transform of the objects done by the transform controls:
+// the same math cocos uses for a node with scaleX/Y, rotationX/Y and skewX/Y (degrees),
+// applied around the anchor
+Affine makeControlTransform(const Vec2 anchor, const float scaleX, const float scaleY,
+							const float rotX, const float rotY, const float warpX, const float warpY);
+
+} // namespace itc
@@ -0,0 +1,50 @@
+#include "AllocCounter.hpp"
+
+#ifdef ITC_ALLOC_COUNTER
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<uint64_t> s_allocations{0};
+
+void* countedAlloc(size_t size) {
+	s_allocations.fetch_add(1, std::memory_order_relaxed);
+	return std::malloc(size ? size : 1);
+}
+} // namespace
+
+// replaceable global allocation functions (over-aligned ones keep the default implementation)
+void* operator new(size_t size) {
+	if (const auto p = countedAlloc(size)) return p;
+	throw std::bad_alloc();
+}
+void* operator new[](size_t size) {
+	if (const auto p = countedAlloc(size)) return p;
+	throw std::bad_alloc();
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+namespace itc {
+uint64_t getAllocationCount() {
+	return s_allocations.load(std::memory_order_relaxed);
+}
+} // namespace itc
+
+#else
+
+namespace itc {
+uint64_t getAllocationCount() {
+	return 0;
+}
+} // namespace itc
+
+#endif
@@ -0,0 +1,19 @@
+#pragma once
+#include <cstdint>
+
+namespace itc {
+
+// Number of operator new calls of the module so far (from any thread). Counted only when
+// built with -DITC_ALLOC_COUNTER=ON, otherwise always 0. Debug aid for keeping the gesture
+// path free of heap allocations (allocations of the game itself aren't seen)
+uint64_t getAllocationCount();
+
+constexpr bool isAllocationCounterEnabled() {
+#ifdef ITC_ALLOC_COUNTER
+	return true;
+#else
+	return false;
+#endif
+}
+
+} // namespace itc
@@ -0,0 +1,138 @@
+#include "AngleHistogram.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace itc {
+
+namespace {
+
+// difference of angles modulo 90 in [-45, 45)
+float angleDiff(const float a, const float b) {
+	float d = std::fmod(a - b, 90.f);
+	if (d >= 45) d -= 90;
+	if (d < -45) d += 90;
+	return d;
+}
+
+} // namespace
+
+float AngleHistogram::normalize(const float rotation) {
+	float angle = std::fmod(rotation, 90.f);
+	if (angle < 0) angle += 90;
+	return angle >= 90 ? 0 : angle;
+}
+
+void AngleHistogram::clear() {
+	m_objects.clear();
+	m_excluded.clear();
+	std::fill(std::begin(m_bins), std::end(m_bins), Bin{});
+	m_total = 0;
+	m_isDirty = true;
+}
+
+void AngleHistogram::add(const float angle) {
+	auto& bin = m_bins[binOf(angle)];
+	bin.m_count++;
+	bin.m_sum += angle;
+	m_total++;
+	m_isDirty = true;
+}
+
+void AngleHistogram::subtract(const float angle) {
+	auto& bin = m_bins[binOf(angle)];
+	bin.m_count--;
+	bin.m_sum = bin.m_count ? bin.m_sum - angle : 0;
+	m_total--;
+	m_isDirty = true;
+}
+
+void AngleHistogram::update(const int id, const float rotation) {
+	const float angle = normalize(rotation);
+	auto [it, inserted] = m_objects.try_emplace(id, Object{angle, false});
+	if (!inserted) {
+		auto& obj = it->second;
+		if (obj.m_angle == angle) return;
+		if (!obj.m_isExcluded) subtract(obj.m_angle);
+		obj.m_angle = angle;
+		if (obj.m_isExcluded) return;
+	}
+	add(angle);
+}
+
+void AngleHistogram::remove(const int id) {
+	const auto it = m_objects.find(id);
+	if (it == m_objects.end()) return;
+	if (!it->second.m_isExcluded) subtract(it->second.m_angle);
+	m_objects.erase(it);
+}
+
+void AngleHistogram::exclude(const int id) {
+	const auto it = m_objects.find(id);
+	if (it == m_objects.end() || it->second.m_isExcluded) return;
+	subtract(it->second.m_angle);
+	it->second.m_isExcluded = true;
+	m_excluded.push_back(id);
+}
+
+void AngleHistogram::includeAll() {
+	for (const int id : m_excluded) {
+		const auto it = m_objects.find(id);
+		if (it == m_objects.end() || !it->second.m_isExcluded) continue;
+		it->second.m_isExcluded = false;
+		add(it->second.m_angle);
+	}
+	m_excluded.clear();
+}
+
+void AngleHistogram::rebuildPeaks() const {
+	m_isDirty = false;
+	m_peaks.clear();
+	// the biggest bins, far enough from multiples of 90 and from each other
+	int order[BIN_COUNT];
+	for (int i = 0; i < BIN_COUNT; i++) order[i] = i;
+	std::sort(std::begin(order), std::end(order), [&](int a, int b) {
+		return m_bins[a].m_count > m_bins[b].m_count;
+	});
+	// a peak must stand out: at least 1% of the objects
+	const uint32_t minCount = std::max(MIN_PEAK_COUNT, m_total / 100);
+	for (const int i : order) {
+		const auto& bin = m_bins[i];
+		if (bin.m_count < minCount || (int)m_peaks.size() == MAX_PEAKS) break;
+		const float angle = float(bin.m_sum / bin.m_count);
+		if (std::abs(angleDiff(angle, 0)) <= SNAP_DEADZONE) continue;
+		const bool isNearPeak = std::any_of(m_peaks.begin(), m_peaks.end(), [&](float peak) {
+			return std::abs(angleDiff(angle, peak)) <= SNAP_DEADZONE;
+		});
+		if (!isNearPeak) m_peaks.push_back(angle);
+	}
+	// closest peak of every bin whose angles can snap to it
+	for (int i = 0; i < BIN_COUNT; i++) {
+		const float center = (i + 0.5f) * BIN_SIZE;
+		float bestDiff = SNAP_DEADZONE + BIN_SIZE;
+		m_binPeaks[i] = -1;
+		for (size_t p = 0; p < m_peaks.size(); p++) {
+			const float diff = std::abs(angleDiff(center, m_peaks[p]));
+			if (diff <= bestDiff) {
+				bestDiff = diff;
+				m_binPeaks[i] = (int8_t)p;
+			}
+		}
+	}
+}
+
+const std::vector<float>& AngleHistogram::getPeaks() const {
+	if (m_isDirty) rebuildPeaks();
+	return m_peaks;
+}
+
+bool AngleHistogram::snap(const float rotation, float* const snapped) const {
+	if (m_isDirty) rebuildPeaks();
+	const int peak = m_binPeaks[binOf(normalize(rotation))];
+	if (peak < 0) return false;
+	const float diff = angleDiff(rotation, m_peaks[peak]);
+	if (std::abs(diff) > SNAP_DEADZONE) return false;
+	*snapped = rotation - diff;
+	return true;
+}
+
+} // namespace itc
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace itc {
+
+// Histogram of the object rotations of the level (modulo 90, in 0.5 degree bins).
+// Like SpatialGrid, objects are added / changed / removed one by one, so it's kept up to
+// date while editing. The most common angles (peaks) are what the rotation snaps to.
+// They're recomputed from the bins only when something changed, so snap() is O(1)
+class AngleHistogram {
+public:
+	static constexpr float BIN_SIZE = 0.5f;
+	static constexpr int BIN_COUNT = 180; // [0, 90)
+	static constexpr int MAX_PEAKS = 4;
+	static constexpr float SNAP_DEADZONE = 2; // same as the snap to multiples of 90
+	static constexpr uint32_t MIN_PEAK_COUNT = 3;
+
+	void clear();
+	size_t size() const { return m_objects.size(); }
+	bool contains(const int id) const { return m_objects.count(id) != 0; }
+
+	// insert or update the object
+	void update(const int id, const float rotation);
+	void remove(const int id);
+
+	// excluded objects are still tracked but don't count (e.g. the objects being rotated)
+	void exclude(const int id);
+	void includeAll();
+
+	// return true and set snapped if the rotation is close to one of the peaks
+	bool snap(const float rotation, float* const snapped) const;
+	// common angles in [0, 90), most common first (multiples of 90 aren't included)
+	const std::vector<float>& getPeaks() const;
+
+private:
+	struct Object {
+		float m_angle; // [0, 90)
+		bool m_isExcluded;
+	};
+	struct Bin {
+		uint32_t m_count = 0;
+		double m_sum = 0; // sum of the angles (peak is the mean angle of its bin)
+	};
+
+	static float normalize(const float rotation);
+	static int binOf(const float angle) { return (int)(angle / BIN_SIZE) % BIN_COUNT; }
+	void add(const float angle);
+	void subtract(const float angle);
+	void rebuildPeaks() const;
+
+	std::unordered_map<int, Object> m_objects;
+	std::vector<int> m_excluded;
+	Bin m_bins[BIN_COUNT];
+	uint32_t m_total = 0;
+	// peaks and the closest peak of every bin (-1 - none in the snap range)
+	mutable bool m_isDirty = true;
+	mutable std::vector<float> m_peaks;
+	mutable int8_t m_binPeaks[BIN_COUNT] = {};
+};
+
+} // namespace itc
@@ -0,0 +1,28 @@
+#include "ControlLogic.hpp"
+#include <cmath>
+
+namespace itc {
+
+bool snapRotation(const float rotation, float* const snapped) {
+	const int rotDiff = (int)(std::abs(rotation) + 0.5) % 90;
+	const int deadzone = 2;
+	if (rotDiff > deadzone && rotDiff < 90 - deadzone) return false;
+	// make obj rot multiple of 90
+	*snapped = (float)(((int)rotation + 10 * (rotation > 0 ? 1 : -1)) / 90 * 90);
+	return true;
+}
+
+uint8_t getAnchorReleaseNode(const TransformFrame& frame, const Vec2 anchor, const float limit,
+								const bool isAnchorSnap, const bool checkCenter, const float maxError) {
+	uint8_t node = 0;
+	Vec2 snap;
+	if (isAnchorSnap && frame.checkAnchorSnaps(limit, anchor, &snap, &node, checkCenter)) {
+		return node;
+	}
+	// the anchor could've snapped to another object that is aligned with the edges,
+	// and some sprites may still stay aligned with the anchor even after transform
+	frame.checkAnchorIsOnEdge(maxError, anchor, &node);
+	return node;
+}
+
+} // namespace itc
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include "Geometry.hpp"
+#include "HandleTopology.hpp"
+#include "TransformFrame.hpp"
+
+// Decisions the transform controls make during a gesture (which sprites are disabled,
+// rotation snap, where the anchor ends up). Shared by the mod and the replay harness
+// (see replay/), so a recorded gesture goes through exactly the same code
+
+namespace itc {
+
+// max error in fp measurements (in points)
+constexpr float MAX_FP_ERROR = 0.01f;
+
+// sprites disabled by the free rotation (all except the rotation one).
+// Masks are bit arrays (see spriteBit())
+constexpr uint16_t FREE_ROT_DISABLED_SPRITES = ALL_SPRITES & ~spriteBit(ROTATE_TAG);
+
+// sprites that are aligned with the anchor when it's on the given node (0 - none)
+inline uint16_t getDisabledSpritesForNode(const uint8_t node) {
+	return node < DISABLED_SPRITES_BY_HANDLE.size() ? DISABLED_SPRITES_BY_HANDLE[node] : 0;
+}
+
+// can't use the button while its sprite is disabled
+inline bool isButtonDisabled(const int buttonType, const uint16_t disabledSprites) {
+	return spriteBit(buttonType) & disabledSprites;
+}
+
+// min dist after which the anchor snaps to a node
+inline float getAnchorSnapLimit(const float anchorScale) {
+	return anchorScale * 18;
+}
+
+// return true and set snapped if the rotation is close to a multiple of 90
+bool snapRotation(const float rotation, float* const snapped);
+
+// node the anchor stays on after the gesture (0 - none). The anchor snaps to the nodes only
+// if it was dragged with the snap enabled, otherwise it's checked to be on the edges
+uint8_t getAnchorReleaseNode(const TransformFrame& frame, const Vec2 anchor, const float limit,
+								const bool isAnchorSnap, const bool checkCenter, const float maxError);
+
+} // namespace itc
@@ -0,0 +1,81 @@
+#include "Geometry.hpp"
+#include <cmath>
+#include "HandleTopology.hpp"
+
+namespace itc {
+
+// M_PI isn't guaranteed without cocos headers (msvc)
+constexpr double DEG_TO_RAD = 3.14159265358979323846 / 180.0;
+
+Vec2 toMainNodeSpace(const Vec2 p, const float rotation) {
+	// math code alert! - m_mainNode is rotated clockwise (cocos style)
+	const double sin = std::sin(rotation*DEG_TO_RAD);
+	const double cos = std::cos(rotation*DEG_TO_RAD);
+	return {float(cos * p.x - sin * p.y), float(sin * p.x + cos * p.y)};
+}
+
+Vec2 fromMainNodeSpace(const Vec2 p, const float rotation) {
+	const double sin = std::sin(rotation*DEG_TO_RAD);
+	const double cos = std::cos(rotation*DEG_TO_RAD);
+	return {float(cos * p.x + sin * p.y), float(-sin * p.x + cos * p.y)};
+}
+
+bool checkAnchorSnaps(const HandlePositions& handles, const float rotation, const float limit,
+						const Vec2 anchor, Vec2* const snapCoords, uint8_t* const spriteIndex,
+						const bool checkCenter) {
+	const auto anchorRelPos = toMainNodeSpace(anchor, rotation);
+	// check distance between the anchor and other sprites
+	for (const auto& handle : HANDLES) {
+		const int i = handle.m_tag;
+		Vec2 nodePos;
+		if (i != ANCHOR_TAG) {
+			nodePos = handles.m_pos[i];
+		} else {
+			if (!checkCenter) continue;
+			// get center
+			nodePos = (handles.m_pos[7] + handles.m_pos[8]) / 2.f;
+		}
+		if ((anchorRelPos - nodePos).lengthSq() < limit * limit) {
+			*snapCoords = fromMainNodeSpace(nodePos, rotation);
+			*spriteIndex = i;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool checkAnchorIsOnEdge(const HandlePositions& handles, const float rotation, const float limit,
+						const Vec2 anchor, uint8_t* const spriteIndex) {
+	const auto C = toMainNodeSpace(anchor, rotation);
+	// vertices cw
+	const Vec2 v[] = {handles.m_pos[6], handles.m_pos[7], handles.m_pos[9], handles.m_pos[8]};
+	uint8_t alignedEdges = 0;
+	// check all rect edges
+	for (int A = 3, B = 0; B < 4; A = B++) {
+		float ABx = v[B].x - v[A].x;
+		float ABy = v[B].y - v[A].y;
+		if (std::abs(ABx) > std::abs(ABy)) {
+			float ACx = C.x - v[A].x;
+			float ACy = C.y - v[A].y;
+			float tg = ABy / ABx;
+			float y = tg * ACx;
+			if (std::abs(ACy - y) < limit) {
+				alignedEdges |= edgeBit(B);
+			}
+		} else {
+			float BCx = v[B].x - C.x;
+			float BCy = v[B].y - C.y;
+			float tg = ABx / ABy;
+			float x = tg * BCy;
+			if (std::abs(BCx - x) < limit) {
+				alignedEdges |= edgeBit(B);
+			}
+		}
+	}
+	const uint8_t tag = HANDLE_BY_EDGES[alignedEdges];
+	if (!tag) return false;
+	*spriteIndex = tag;
+	return true;
+}
+
+} // namespace itc
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+
+// Geometry used by the transform controls snapping.
+// This part doesn't depend on Geode or cocos, so it can be built and benchmarked
+// on its own (see bench/)
+
+namespace itc {
+
+struct Vec2 {
+	float x = 0;
+	float y = 0;
+
+	constexpr Vec2 operator+(const Vec2 o) const { return {x + o.x, y + o.y}; }
+	constexpr Vec2 operator-(const Vec2 o) const { return {x - o.x, y - o.y}; }
+	constexpr Vec2 operator*(const float k) const { return {x * k, y * k}; }
+	constexpr Vec2 operator/(const float k) const { return {x / k, y / k}; }
+	constexpr float dot(const Vec2 o) const { return x * o.x + y * o.y; }
+	constexpr float lengthSq() const { return x * x + y * y; }
+};
+
+// axis aligned rectangle
+struct Rect {
+	Vec2 m_min;
+	Vec2 m_max;
+
+	constexpr Vec2 center() const { return (m_min + m_max) / 2.f; }
+	constexpr bool intersects(const Rect& o) const {
+		return m_min.x <= o.m_max.x && o.m_min.x <= m_max.x && m_min.y <= o.m_max.y && o.m_min.y <= m_max.y;
+	}
+	// the rect grown by d on every side
+	constexpr Rect expanded(const float d) const { return {m_min - Vec2{d, d}, m_max + Vec2{d, d}}; }
+	constexpr bool operator==(const Rect& o) const {
+		return m_min.x == o.m_min.x && m_min.y == o.m_min.y && m_max.x == o.m_max.x && m_max.y == o.m_max.y;
+	}
+};
+
+// positions of the transform control sprites 2-9 in m_mainNode coords, indexed by
+// sprite tag (indexes 0 and 1 are unused, see the scheme in main.cpp)
+struct HandlePositions {
+	Vec2 m_pos[10];
+};
+
+// convert a point from the transform control coords to the (rotated) m_mainNode coords
+Vec2 toMainNodeSpace(const Vec2 p, const float rotation);
+
+// convert a point from m_mainNode coords back to the transform control coords
+Vec2 fromMainNodeSpace(const Vec2 p, const float rotation);
+
+// return true and set snapCoords and spriteIndex if anchor snaps to one of the sprites
+// (anchor and snapCoords are in transform control coords)
+bool checkAnchorSnaps(const HandlePositions& handles, const float rotation, const float limit,
+						const Vec2 anchor, Vec2* const snapCoords, uint8_t* const spriteIndex,
+						const bool checkCenter);
+
+// check if the anchor is aligned with the edges of rectangle or their extensions.
+// returns the result and sets the spriteIndex
+bool checkAnchorIsOnEdge(const HandlePositions& handles, const float rotation, const float limit,
+						const Vec2 anchor, uint8_t* const spriteIndex);
+
+} // namespace itc
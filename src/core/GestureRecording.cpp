@@ -0,0 +1,137 @@
+#include "GestureRecording.hpp"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <type_traits>
+
+namespace itc {
+
+namespace {
+
+constexpr char MAGIC[4] = {'I', 'T', 'C', 'G'};
+
+// all the platforms the game runs on are little endian, so values are copied as they are
+class Writer {
+public:
+	explicit Writer(std::vector<uint8_t>& out) : m_out(out) {}
+
+	template <class T>
+	void write(const T value) {
+		static_assert(std::is_arithmetic_v<T>);
+		const auto bytes = reinterpret_cast<const uint8_t*>(&value);
+		m_out.insert(m_out.end(), bytes, bytes + sizeof(T));
+	}
+	void write(const Vec2 v) { write(v.x); write(v.y); }
+	void writeHandles(const HandlePositions& handles) {
+		for (int i = 2; i < 10; i++) write(handles.m_pos[i]);
+	}
+
+private:
+	std::vector<uint8_t>& m_out;
+};
+
+class Reader {
+public:
+	Reader(const uint8_t* data, const size_t size) : m_data(data), m_size(size) {}
+
+	template <class T>
+	bool read(T* value) {
+		static_assert(std::is_arithmetic_v<T>);
+		if (m_size - m_pos < sizeof(T)) return false;
+		std::memcpy(value, m_data + m_pos, sizeof(T));
+		m_pos += sizeof(T);
+		return true;
+	}
+	bool read(Vec2* v) { return read(&v->x) && read(&v->y); }
+	bool readHandles(HandlePositions* handles) {
+		for (int i = 2; i < 10; i++) {
+			if (!read(&handles->m_pos[i])) return false;
+		}
+		return true;
+	}
+	bool atEnd() const { return m_pos == m_size; }
+
+private:
+	const uint8_t* m_data;
+	size_t m_size;
+	size_t m_pos = 0;
+};
+
+} // namespace
+
+std::vector<uint8_t> GestureRecording::serialize() const {
+	std::vector<uint8_t> out(std::begin(MAGIC), std::end(MAGIC));
+	Writer w(out);
+	w.write(VERSION);
+
+	const auto& h = m_header;
+	w.write(h.m_flags);
+	w.write(h.m_selectionSize);
+	w.write(h.m_anchorScale);
+	w.write(h.m_lockedRotation);
+	w.write(h.m_disabledSpritesSnap);
+	w.write(h.m_disabledSpritesRot);
+	w.write(h.m_rotation);
+	w.write(h.m_anchor);
+	w.writeHandles(h.m_handles);
+
+	for (const auto& e : m_events) {
+		w.write((uint8_t)e.m_type);
+		w.write(e.m_buttonType);
+		w.write(e.m_flags);
+		w.write(e.m_time);
+		w.write(e.m_touch);
+		w.write(e.m_rotation);
+		w.write(e.m_anchor);
+		w.writeHandles(e.m_handles);
+		w.write(e.m_resultRotation);
+		w.write(e.m_resultAnchor);
+		w.write(e.m_resultDisabledSprites);
+	}
+	return out;
+}
+
+bool GestureRecording::deserialize(const uint8_t* data, const size_t size, GestureRecording* out) {
+	if (size < sizeof(MAGIC) || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) return false;
+	Reader r(data + sizeof(MAGIC), size - sizeof(MAGIC));
+	uint16_t version;
+	if (!r.read(&version) || version != VERSION) return false;
+
+	GestureRecording rec;
+	auto& h = rec.m_header;
+	const bool ok = r.read(&h.m_flags) && r.read(&h.m_selectionSize) && r.read(&h.m_anchorScale)
+		&& r.read(&h.m_lockedRotation) && r.read(&h.m_disabledSpritesSnap) && r.read(&h.m_disabledSpritesRot)
+		&& r.read(&h.m_rotation) && r.read(&h.m_anchor) && r.readHandles(&h.m_handles);
+	if (!ok) return false;
+
+	while (!r.atEnd()) {
+		GestureEvent e;
+		uint8_t type;
+		const bool ok = r.read(&type) && r.read(&e.m_buttonType) && r.read(&e.m_flags)
+			&& r.read(&e.m_time) && r.read(&e.m_touch) && r.read(&e.m_rotation) && r.read(&e.m_anchor)
+			&& r.readHandles(&e.m_handles) && r.read(&e.m_resultRotation) && r.read(&e.m_resultAnchor)
+			&& r.read(&e.m_resultDisabledSprites);
+		if (!ok || type > GestureEvent::Cancelled) return false;
+		e.m_type = (GestureEvent::Type)type;
+		rec.m_events.push_back(e);
+	}
+	*out = std::move(rec);
+	return true;
+}
+
+bool GestureRecording::save(const std::filesystem::path& path) const {
+	const auto data = serialize();
+	std::ofstream file(path, std::ios::binary);
+	if (!file) return false;
+	file.write(reinterpret_cast<const char*>(data.data()), (std::streamsize)data.size());
+	return (bool)file;
+}
+
+bool GestureRecording::load(const std::filesystem::path& path, GestureRecording* out) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) return false;
+	const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	return deserialize(data.data(), data.size(), out);
+}
+
+} // namespace itc
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+#include "Geometry.hpp"
+
+// Recorded transform controls gesture: the state of the controls when the touch began and
+// every touch event after it. For each event it keeps the state RobTop's code produced
+// (so the replay doesn't need the game) and the state after the mod (to check the replay).
+//
+// File format (little endian, no padding):
+//   "ITCG" u16:version  header  event*
+//   header: u16:flags u32:selection f32:anchorScale f32:lockedRotation u16:disabledSnap
+//           u16:disabledRot f32:rotation Vec2:anchor Vec2[8]:handles 2-9
+//   event:  u8:type u8:button u8:flags f32:time Vec2:touch f32:rotation Vec2:anchor
+//           Vec2[8]:handles 2-9 f32:resultRotation Vec2:resultAnchor u16:resultDisabled
+
+namespace itc {
+
+struct GestureHeader {
+	enum Flags : uint16_t {
+		Snap = 1 << 0,
+		FreeRot = 1 << 1,
+		CenterSnap = 1 << 2,
+		ObjectSnap = 1 << 3,
+	};
+	uint16_t m_flags = 0;
+	uint32_t m_selectionSize = 0;
+	float m_anchorScale = 1;
+	float m_lockedRotation = 0;
+	uint16_t m_disabledSpritesSnap = 0;
+	uint16_t m_disabledSpritesRot = 0;
+	float m_rotation = 0;       // m_mainNode rotation
+	Vec2 m_anchor;              // transform control coords
+	HandlePositions m_handles;  // 2-9
+
+	bool hasFlag(const Flags flag) const { return m_flags & flag; }
+};
+
+struct GestureEvent {
+	enum Type : uint8_t { Began, Moved, Ended, Cancelled };
+	enum Flags : uint8_t {
+		AnchorSnapped = 1 << 0,   // anchor snapped to a node
+		ObjectSnapped = 1 << 1,   // anchor snapped to an object (can't be replayed without the level)
+		RotationSnapped = 1 << 2,
+		AngleSnapped = 1 << 3,    // rotation snapped to a common angle of the level (same as ObjectSnapped)
+		LineSnapped = 1 << 4,     // anchor snapped to the grid or a guide (same as ObjectSnapped)
+		HandleSnapped = 1 << 5,   // touch of a scale handle snapped to the grid or a guide (before RobTop's code)
+	};
+	Type m_type = Moved;
+	uint8_t m_buttonType = 0;
+	uint8_t m_flags = 0;
+	float m_time = 0;           // seconds since the touch began
+	Vec2 m_touch;               // transform control coords
+	// after RobTop's code
+	float m_rotation = 0;
+	Vec2 m_anchor;
+	HandlePositions m_handles;
+	// after the mod
+	float m_resultRotation = 0;
+	Vec2 m_resultAnchor;
+	uint16_t m_resultDisabledSprites = 0;
+
+	bool hasFlag(const Flags flag) const { return m_flags & flag; }
+};
+
+struct GestureRecording {
+	static constexpr uint16_t VERSION = 1;
+
+	GestureHeader m_header;
+	std::vector<GestureEvent> m_events;
+
+	std::vector<uint8_t> serialize() const;
+	// false if the data isn't a valid recording
+	static bool deserialize(const uint8_t* data, const size_t size, GestureRecording* out);
+
+	bool save(const std::filesystem::path& path) const;
+	static bool load(const std::filesystem::path& path, GestureRecording* out);
+};
+
+} // namespace itc
@@ -0,0 +1,107 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+// Layout of the transform control handles (see the scheme in main.cpp), described once.
+// The masks and lookup tables used during the gesture are generated from it at compile time,
+// so a new handle only needs a new entry in HANDLES
+
+namespace itc {
+
+// sprites have tags 1-12
+constexpr int SPRITE_COUNT = 12;
+constexpr int ANCHOR_TAG = 1;
+constexpr int ROTATE_TAG = 12;
+
+// bit of the sprite in the masks: the lowest 12 bits, highest one is sprite 1
+constexpr uint16_t spriteBit(const int tag) {
+	return (uint16_t)(0b1000000000000 >> tag);
+}
+
+constexpr uint16_t ALL_SPRITES = 0b111111111111;
+
+// edges of the rect in the order of TransformFrame (clockwise starting from the left one)
+constexpr int EDGE_COUNT = 4;
+
+constexpr uint8_t edgeBit(const int edge) {
+	return (uint8_t)(0b1000 >> edge);
+}
+
+enum Edge : uint8_t {
+	EdgeLeft = edgeBit(0),
+	EdgeTop = edgeBit(1),
+	EdgeRight = edgeBit(2),
+	EdgeBottom = edgeBit(3),
+};
+
+// sprite the anchor can snap to and the edges it lies on (the center lies on none)
+struct Handle {
+	uint8_t m_tag;
+	uint8_t m_edges;
+};
+
+// in the snap priority order
+constexpr Handle HANDLES[] = {
+	{ANCHOR_TAG, 0}, // center of the rect
+	{2, EdgeLeft},
+	{3, EdgeRight},
+	{4, EdgeTop},
+	{5, EdgeBottom},
+	{6, EdgeLeft | EdgeTop},
+	{7, EdgeTop | EdgeRight},
+	{8, EdgeLeft | EdgeBottom},
+	{9, EdgeRight | EdgeBottom},
+};
+
+constexpr size_t HANDLE_COUNT = std::size(HANDLES);
+
+// table[i] = gen(i)
+template <class T, size_t N, class Gen>
+constexpr std::array<T, N> generateTable(Gen gen) {
+	std::array<T, N> table{};
+	for (size_t i = 0; i < N; i++) table[i] = gen(i);
+	return table;
+}
+
+// sprites aligned with the anchor when it's on the handle (every handle that shares
+// an edge with it), indexed by tag
+constexpr auto DISABLED_SPRITES_BY_HANDLE = generateTable<uint16_t, SPRITE_COUNT + 1>([](size_t tag) {
+	uint8_t edges = 0;
+	for (const auto& h : HANDLES) {
+		if (h.m_tag == tag) edges = h.m_edges;
+	}
+	uint16_t mask = 0;
+	for (const auto& h : HANDLES) {
+		if (h.m_edges & edges) mask |= spriteBit(h.m_tag);
+	}
+	return mask;
+});
+
+// edges the handle lies on, indexed by tag (0 - not a handle or the center)
+constexpr auto EDGES_BY_HANDLE = generateTable<uint8_t, SPRITE_COUNT + 1>([](size_t tag) {
+	for (const auto& h : HANDLES) {
+		if (h.m_tag == tag) return h.m_edges;
+	}
+	return (uint8_t)0;
+});
+
+// handle that lies exactly on the given edges (0 - none), indexed by the edge bits
+constexpr auto HANDLE_BY_EDGES = generateTable<uint8_t, 1 << EDGE_COUNT>([](size_t edges) {
+	for (const auto& h : HANDLES) {
+		if (h.m_edges && h.m_edges == edges) return h.m_tag;
+	}
+	return (uint8_t)0;
+});
+
+// the masks that used to be written by hand
+static_assert(DISABLED_SPRITES_BY_HANDLE[2] == 0b010001010000);
+static_assert(DISABLED_SPRITES_BY_HANDLE[6] == 0b010101110000);
+static_assert(DISABLED_SPRITES_BY_HANDLE[9] == 0b001010111000);
+static_assert(DISABLED_SPRITES_BY_HANDLE[ANCHOR_TAG] == 0);
+static_assert(HANDLE_BY_EDGES[EdgeLeft | EdgeBottom] == 8);
+static_assert(EDGES_BY_HANDLE[7] == (EdgeTop | EdgeRight));
+static_assert(HANDLE_BY_EDGES[EdgeLeft | EdgeRight] == 0);
+
+} // namespace itc
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace itc {
+
+// Small least-recently-used cache: get() and put() are O(1), the least recently used
+// entry is dropped when the cache is full
+template <class Key, class Value>
+class LruCache {
+public:
+	explicit LruCache(const size_t capacity) : m_capacity(capacity) {}
+
+	size_t size() const { return m_map.size(); }
+	size_t capacity() const { return m_capacity; }
+
+	void clear() {
+		m_entries.clear();
+		m_map.clear();
+	}
+
+	// nullptr if there's no such entry. The entry becomes the most recently used one
+	Value* get(const Key& key) {
+		const auto it = m_map.find(key);
+		if (it == m_map.end()) return nullptr;
+		m_entries.splice(m_entries.begin(), m_entries, it->second);
+		return &it->second->second;
+	}
+
+	void put(const Key& key, Value value) {
+		if (const auto it = m_map.find(key); it != m_map.end()) {
+			it->second->second = std::move(value);
+			m_entries.splice(m_entries.begin(), m_entries, it->second);
+			return;
+		}
+		if (m_capacity == 0) return;
+		if (m_map.size() >= m_capacity) {
+			m_map.erase(m_entries.back().first);
+			m_entries.pop_back();
+		}
+		m_entries.emplace_front(key, std::move(value));
+		m_map.emplace(key, m_entries.begin());
+	}
+
+	void remove(const Key& key) {
+		const auto it = m_map.find(key);
+		if (it == m_map.end()) return;
+		m_entries.erase(it->second);
+		m_map.erase(it);
+	}
+
+private:
+	using Entry = std::pair<Key, Value>;
+	size_t m_capacity;
+	std::list<Entry> m_entries; // most recently used first
+	std::unordered_map<Key, typename std::list<Entry>::iterator> m_map;
+};
+
+} // namespace itc
@@ -0,0 +1,233 @@
+#include "OrientedBounds.hpp"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include "WorkerPool.hpp"
+
+namespace itc {
+
+constexpr double RAD_TO_DEG = 180.0 / 3.14159265358979323846;
+
+namespace {
+
+// below this the threads cost more than they save
+constexpr size_t PARALLEL_MIN_POINTS = 65536;
+
+double cross(const Vec2 o, const Vec2 a, const Vec2 b) {
+	return ((double)a.x - o.x) * ((double)b.y - o.y) - ((double)a.y - o.y) * ((double)b.x - o.x);
+}
+
+// points that are the furthest in 8 directions, counterclockwise starting from +x
+struct Extremes {
+	Vec2 m_points[8];
+	float m_values[8];
+
+	void init(const Vec2 p) {
+		for (int i = 0; i < 8; i++) {
+			m_points[i] = p;
+			m_values[i] = value(i, p);
+		}
+	}
+
+	static float value(const int dir, const Vec2 p) {
+		switch (dir) {
+			case 0: return p.x;
+			case 1: return p.x + p.y;
+			case 2: return p.y;
+			case 3: return p.y - p.x;
+			case 4: return -p.x;
+			case 5: return -p.x - p.y;
+			case 6: return -p.y;
+			default: return p.x - p.y;
+		}
+	}
+
+	void add(const Vec2 p) {
+		for (int i = 0; i < 8; i++) {
+			const float v = value(i, p);
+			if (v > m_values[i]) {
+				m_values[i] = v;
+				m_points[i] = p;
+			}
+		}
+	}
+
+	void merge(const Extremes& o) {
+		for (int i = 0; i < 8; i++) {
+			if (o.m_values[i] > m_values[i]) {
+				m_values[i] = o.m_values[i];
+				m_points[i] = o.m_points[i];
+			}
+		}
+	}
+};
+
+// Octagon of the extreme points as lines (n.p > offset inside). The same point can be
+// extreme in several directions, such sides are skipped
+class Octagon {
+public:
+	explicit Octagon(const Extremes& e) {
+		for (int i = 0; i < 8; i++) {
+			const auto a = e.m_points[i], b = e.m_points[(i + 1) % 8];
+			if (a.x == b.x && a.y == b.y) continue;
+			// left normal of a->b (the octagon is counterclockwise)
+			m_normalsX[m_sides] = (double)a.y - b.y;
+			m_normalsY[m_sides] = (double)b.x - a.x;
+			m_offsets[m_sides] = m_normalsX[m_sides] * a.x + m_normalsY[m_sides] * a.y;
+			m_sides++;
+		}
+	}
+
+	// strictly inside (points on the sides are kept)
+	bool isInside(const Vec2 p) const {
+		if (m_sides < 3) return false;
+		for (int i = 0; i < m_sides; i++) {
+			if (m_normalsX[i] * p.x + m_normalsY[i] * p.y <= m_offsets[i]) return false;
+		}
+		return true;
+	}
+
+private:
+	double m_normalsX[8];
+	double m_normalsY[8];
+	double m_offsets[8];
+	int m_sides = 0;
+};
+
+} // namespace
+
+std::vector<Vec2> filterHullCandidates(const std::vector<Vec2>& points, WorkerPool* const pool) {
+	const size_t count = points.size();
+	if (count < 16) return points;
+
+	if (!pool || count < PARALLEL_MIN_POINTS) {
+		Extremes e;
+		e.init(points[0]);
+		for (const auto p : points) e.add(p);
+		const Octagon octagon(e);
+		std::vector<Vec2> out;
+		for (const auto p : points) {
+			if (!octagon.isInside(p)) out.push_back(p);
+		}
+		return out;
+	}
+
+	std::mutex mutex;
+	Extremes e;
+	e.init(points[0]);
+	pool->parallelFor(count, 1, [&](size_t begin, size_t end) {
+		Extremes local;
+		local.init(points[begin]);
+		for (size_t i = begin; i < end; i++) local.add(points[i]);
+		std::lock_guard lock(mutex);
+		e.merge(local);
+	});
+	const Octagon octagon(e);
+	// chunks are joined in order, so the result is the same as without the pool
+	std::map<size_t, std::vector<Vec2>> chunks;
+	pool->parallelFor(count, 1, [&](size_t begin, size_t end) {
+		std::vector<Vec2> local;
+		for (size_t i = begin; i < end; i++) {
+			if (!octagon.isInside(points[i])) local.push_back(points[i]);
+		}
+		std::lock_guard lock(mutex);
+		chunks.emplace(begin, std::move(local));
+	});
+	std::vector<Vec2> out;
+	for (auto& [begin, chunk] : chunks) out.insert(out.end(), chunk.begin(), chunk.end());
+	return out;
+}
+
+std::vector<Vec2> convexHull(std::vector<Vec2> points) {
+	std::sort(points.begin(), points.end(), [](const Vec2 a, const Vec2 b) {
+		return a.x < b.x || (a.x == b.x && a.y < b.y);
+	});
+	points.erase(std::unique(points.begin(), points.end(), [](const Vec2 a, const Vec2 b) {
+		return a.x == b.x && a.y == b.y;
+	}), points.end());
+	if (points.size() < 3) return points;
+
+	std::vector<Vec2> hull(points.size() * 2);
+	size_t k = 0;
+	// lower
+	for (const auto p : points) {
+		while (k >= 2 && cross(hull[k - 2], hull[k - 1], p) <= 0) k--;
+		hull[k++] = p;
+	}
+	// upper
+	const size_t lower = k + 1;
+	for (size_t i = points.size() - 1; i-- > 0;) {
+		while (k >= lower && cross(hull[k - 2], hull[k - 1], points[i]) <= 0) k--;
+		hull[k++] = points[i];
+	}
+	hull.resize(k - 1); // the last point is the first one
+	return hull;
+}
+
+OrientedRect minAreaRect(const std::vector<Vec2>& hull) {
+	const size_t n = hull.size();
+	if (n == 0) return {};
+	if (n == 1) return {hull[0], {0, 0}, 0};
+	if (n == 2) {
+		const auto d = hull[1] - hull[0];
+		float angle = (float)(std::atan2(d.y, d.x) * RAD_TO_DEG);
+		Vec2 size = {std::sqrt(d.lengthSq()), 0};
+		while (angle < 0) angle += 90, size = {size.y, size.x};
+		while (angle >= 90) angle -= 90, size = {size.y, size.x};
+		return {(hull[0] + hull[1]) / 2.f, size, angle};
+	}
+
+	auto proj = [&](const size_t i, const double ux, const double uy, const Vec2 o) {
+		return ((double)hull[i % n].x - o.x) * ux + ((double)hull[i % n].y - o.y) * uy;
+	};
+
+	double bestArea = -1;
+	OrientedRect best;
+	// calipers: furthest along the edge, furthest from the edge, furthest back along the edge
+	size_t right = 1, top = 1, left = 1;
+	for (size_t i = 0; i < n; i++) {
+		const Vec2 o = hull[i];
+		const Vec2 e = hull[(i + 1) % n] - o;
+		const double len = std::sqrt((double)e.x * e.x + (double)e.y * e.y);
+		if (len == 0) continue;
+		const double ux = e.x / len, uy = e.y / len;
+		// normal pointing inside (the hull is counterclockwise)
+		const double nx = -uy, ny = ux;
+
+		if (right < i + 1) right = i + 1;
+		while (right < i + n && proj(right + 1, ux, uy, o) >= proj(right, ux, uy, o)) right++;
+		if (top < right) top = right;
+		while (top < i + n && proj(top + 1, nx, ny, o) >= proj(top, nx, ny, o)) top++;
+		if (left < top) left = top;
+		while (left < i + n && proj(left + 1, ux, uy, o) <= proj(left, ux, uy, o)) left++;
+
+		const double maxU = proj(right, ux, uy, o);
+		const double minU = proj(left, ux, uy, o);
+		const double height = proj(top, nx, ny, o);
+		const double area = (maxU - minU) * height;
+		if (bestArea >= 0 && area >= bestArea) continue;
+		bestArea = area;
+		const double midU = (maxU + minU) / 2, midN = height / 2;
+		best.m_center = {(float)(o.x + ux * midU + nx * midN), (float)(o.y + uy * midU + ny * midN)};
+		best.m_size = {(float)(maxU - minU), (float)height};
+		best.m_angle = (float)(std::atan2(uy, ux) * RAD_TO_DEG);
+	}
+
+	// same rect with the angle in [0, 90)
+	while (best.m_angle < 0) {
+		best.m_angle += 90;
+		best.m_size = {best.m_size.y, best.m_size.x};
+	}
+	while (best.m_angle >= 90) {
+		best.m_angle -= 90;
+		best.m_size = {best.m_size.y, best.m_size.x};
+	}
+	return best;
+}
+
+OrientedRect computeMinAreaRect(const std::vector<Vec2>& points, WorkerPool* const pool) {
+	return minAreaRect(convexHull(filterHullCandidates(points, pool)));
+}
+
+} // namespace itc
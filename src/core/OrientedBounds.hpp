@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+#include "Geometry.hpp"
+
+namespace itc {
+
+class WorkerPool;
+
+// rectangle rotated by m_angle (degrees, counterclockwise, in [0, 90))
+struct OrientedRect {
+	Vec2 m_center;
+	Vec2 m_size;
+	float m_angle = 0;
+
+	float area() const { return m_size.x * m_size.y; }
+};
+
+// Akl-Toussaint heuristic: drop the points inside the octagon of the extreme points
+// (x, y, x+y, x-y), they can't be on the hull. Usually leaves a small part of the points.
+// With a pool the points are split across the threads (the result doesn't depend on it)
+std::vector<Vec2> filterHullCandidates(const std::vector<Vec2>& points, WorkerPool* const pool = nullptr);
+
+// convex hull (Andrew's monotone chain): counterclockwise, without collinear points
+std::vector<Vec2> convexHull(std::vector<Vec2> points);
+
+// minimum area rectangle around the convex polygon (rotating calipers, one side of
+// the rectangle lies on a side of the polygon)
+OrientedRect minAreaRect(const std::vector<Vec2>& hull);
+
+// minimum area rectangle around the points (filter + hull + calipers)
+OrientedRect computeMinAreaRect(const std::vector<Vec2>& points, WorkerPool* const pool = nullptr);
+
+} // namespace itc
@@ -0,0 +1,95 @@
+#include "Profiler.hpp"
+#include <bit>
+#include <cstdio>
+
+namespace itc {
+
+int LatencyHistogram::bucketIndex(const uint64_t ns) {
+	if (ns < SUB_BUCKETS) return (int)ns;
+	const int exp = 63 - std::countl_zero(ns); // >= 3
+	const int sub = (int)((ns >> (exp - 3)) & (SUB_BUCKETS - 1));
+	return (exp - 2) * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(const int index) {
+	if (index < SUB_BUCKETS) return (uint64_t)index;
+	const int exp = index / SUB_BUCKETS + 2;
+	const uint64_t sub = index % SUB_BUCKETS;
+	return ((SUB_BUCKETS + sub + 1) << (exp - 3)) - 1;
+}
+
+void LatencyHistogram::record(const uint64_t ns) {
+	const int index = bucketIndex(ns);
+	m_buckets[index < BUCKETS ? index : BUCKETS - 1]++;
+	m_count++;
+	if (ns > m_max) m_max = ns;
+}
+
+uint64_t LatencyHistogram::getPercentile(const double p) const {
+	if (m_count == 0) return 0;
+	const uint64_t target = (uint64_t)(p * (double)(m_count - 1)) + 1;
+	uint64_t seen = 0;
+	for (int i = 0; i < BUCKETS; i++) {
+		seen += m_buckets[i];
+		if (seen >= target) return bucketUpperBound(i) < m_max ? bucketUpperBound(i) : m_max;
+	}
+	return m_max;
+}
+
+Profiler& Profiler::get() {
+	static Profiler profiler;
+	return profiler;
+}
+
+const char* Profiler::getHookName(const Hook hook) {
+	switch (hook) {
+		case TouchMoved: return "ccTouchMoved";
+		case TouchEnded: return "ccTouchEnded";
+		case TransformObjects: return "transformObjects";
+		case UpdateTransformControl: return "updateTransformControl";
+		case ActivateTransformControl: return "activateTransformControl";
+		case InterfaceDraw: return "interfaceDraw";
+		default: return "?";
+	}
+}
+
+const char* Profiler::getSizeClassName(const int sizeClass) {
+	constexpr const char* names[SIZE_CLASSES] = {"<100", "<1k", "<10k", "10k+"};
+	return names[sizeClass];
+}
+
+int Profiler::getSizeClass(const size_t selectionSize) {
+	if (selectionSize < 100) return 0;
+	if (selectionSize < 1000) return 1;
+	if (selectionSize < 10000) return 2;
+	return 3;
+}
+
+void Profiler::reset() {
+	for (auto& hook : m_histograms) {
+		for (auto& histogram : hook) histogram.reset();
+	}
+}
+
+void Profiler::record(const Hook hook, const uint64_t ns, const size_t selectionSize) {
+	m_histograms[hook][getSizeClass(selectionSize)].record(ns);
+	m_lastSelectionSize = selectionSize;
+}
+
+std::string Profiler::toCsv() const {
+	std::string csv = "hook,selection,count,p50_us,p99_us,max_us\n";
+	char line[128];
+	for (int hook = 0; hook < HookCount; hook++) {
+		for (int size = 0; size < SIZE_CLASSES; size++) {
+			const auto& h = m_histograms[hook][size];
+			if (h.getCount() == 0) continue;
+			std::snprintf(line, sizeof(line), "%s,%s,%llu,%.3f,%.3f,%.3f\n",
+				getHookName((Hook)hook), getSizeClassName(size), (unsigned long long)h.getCount(),
+				h.getPercentile(0.5) / 1000.0, h.getPercentile(0.99) / 1000.0, h.getMax() / 1000.0);
+			csv += line;
+		}
+	}
+	return csv;
+}
+
+} // namespace itc
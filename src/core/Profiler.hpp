@@ -0,0 +1,101 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace itc {
+
+// Histogram of latencies (ns) with ~12% precision: 8 sub-buckets for every power of 2
+class LatencyHistogram {
+public:
+	void record(const uint64_t ns);
+	void reset() { *this = {}; }
+
+	uint64_t getCount() const { return m_count; }
+	uint64_t getMax() const { return m_max; }
+	// upper bound of the bucket where the p-th (0..1) latency is
+	uint64_t getPercentile(const double p) const;
+
+private:
+	static constexpr int SUB_BUCKETS = 8;
+	static constexpr int BUCKETS = (64 - 2) * SUB_BUCKETS;
+	static int bucketIndex(const uint64_t ns);
+	static uint64_t bucketUpperBound(const int index);
+
+	std::array<uint32_t, BUCKETS> m_buckets = {};
+	uint64_t m_count = 0;
+	uint64_t m_max = 0;
+};
+
+// Latencies of the mod hooks, per hook and per selection size
+class Profiler {
+public:
+	enum Hook {
+		TouchMoved,
+		TouchEnded,
+		TransformObjects,
+		UpdateTransformControl,
+		ActivateTransformControl,
+		InterfaceDraw,
+		HookCount
+	};
+	// selection sizes: <100, <1k, <10k, 10k+
+	static constexpr int SIZE_CLASSES = 4;
+
+	static Profiler& get();
+	static const char* getHookName(const Hook hook);
+	static const char* getSizeClassName(const int sizeClass);
+	static int getSizeClass(const size_t selectionSize);
+
+	bool isEnabled() const { return m_enabled; }
+	void setEnabled(const bool enabled) { m_enabled = enabled; }
+	void reset();
+
+	void record(const Hook hook, const uint64_t ns, const size_t selectionSize);
+
+	const LatencyHistogram& getHistogram(const Hook hook, const int sizeClass) const { return m_histograms[hook][sizeClass]; }
+	size_t getLastSelectionSize() const { return m_lastSelectionSize; }
+	// histogram for the size of the last measured selection
+	const LatencyHistogram& getCurrent(const Hook hook) const {
+		return m_histograms[hook][getSizeClass(m_lastSelectionSize)];
+	}
+
+	// hook,selection,count,p50_us,p99_us,max_us
+	std::string toCsv() const;
+
+private:
+	bool m_enabled = false;
+	size_t m_lastSelectionSize = 0;
+	LatencyHistogram m_histograms[HookCount][SIZE_CLASSES];
+};
+
+// Measures the scope if the profiler is enabled. When it's disabled, this is one branch
+class ScopedTimer {
+public:
+	explicit ScopedTimer(const Profiler::Hook hook) : m_hook(hook), m_active(Profiler::get().isEnabled()) {
+		if (m_active) m_start = std::chrono::steady_clock::now();
+	}
+	~ScopedTimer() {
+		if (!m_active) return;
+		const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - m_start).count();
+		Profiler::get().record(m_hook, (uint64_t)ns, m_selectionSize);
+	}
+	bool isActive() const { return m_active; }
+	void setSelectionSize(const size_t size) { m_selectionSize = size; }
+
+private:
+	Profiler::Hook m_hook;
+	bool m_active;
+	size_t m_selectionSize = 0;
+	std::chrono::steady_clock::time_point m_start;
+};
+
+} // namespace itc
+
+// time the rest of the scope (selectionSize is evaluated only when the profiler is enabled)
+#define ITC_PROFILE_SCOPE(hook, selectionSize) \
+	itc::ScopedTimer itcScopedTimer_(itc::Profiler::hook); \
+	if (itcScopedTimer_.isActive()) itcScopedTimer_.setSelectionSize(selectionSize)
@@ -0,0 +1,52 @@
+#include "ScratchArena.hpp"
+#include <algorithm>
+
+namespace itc {
+
+ScratchArena& ScratchArena::gesture() {
+	static ScratchArena arena;
+	return arena;
+}
+
+void* ScratchArena::allocate(const size_t size, const size_t align) {
+	while (m_block < m_blocks.size()) {
+		auto& block = m_blocks[m_block];
+		const size_t begin = (m_offset + align - 1) / align * align;
+		if (begin + size <= block.m_size) {
+			m_offset = begin + size;
+			m_used = std::max(m_used, getUsedBefore(m_block) + m_offset);
+			return block.m_data.get() + begin;
+		}
+		m_block++;
+		m_offset = 0;
+	}
+	// new block (the data is aligned for any type, std::byte[] uses operator new)
+	const size_t blockSize = std::max(m_blockSize, size + align);
+	m_blocks.push_back({std::make_unique<std::byte[]>(blockSize), blockSize});
+	m_block = m_blocks.size() - 1;
+	m_offset = 0;
+	return allocate(size, align);
+}
+
+size_t ScratchArena::getUsedBefore(const size_t block) const {
+	size_t used = 0;
+	for (size_t i = 0; i < block; i++) used += m_blocks[i].m_size;
+	return used;
+}
+
+void ScratchArena::reset() {
+	if (m_blocks.size() > 1) {
+		const size_t size = std::max(m_blockSize, m_used);
+		m_blocks.clear();
+		m_blocks.push_back({std::make_unique<std::byte[]>(size), size});
+	}
+	m_block = 0;
+	m_offset = 0;
+	m_used = 0;
+}
+
+size_t ScratchArena::getCapacity() const {
+	return getUsedBefore(m_blocks.size());
+}
+
+} // namespace itc
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace itc {
+
+// Bump allocator for temporary data of a transform gesture. Nothing is freed one by one:
+// the whole arena is reset when the gesture ends (or rewound to a mark), and the memory
+// is kept for the next gesture, so a steady drag doesn't touch the heap
+class ScratchArena {
+public:
+	explicit ScratchArena(const size_t blockSize = 64 * 1024) : m_blockSize(blockSize) {}
+
+	ScratchArena(const ScratchArena&) = delete;
+	ScratchArena& operator=(const ScratchArena&) = delete;
+
+	// arena of the transform gesture, reset when the touch ends (main thread only)
+	static ScratchArena& gesture();
+
+	void* allocate(const size_t size, const size_t align);
+
+	template <class T>
+	T* allocate(const size_t count) {
+		return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+	}
+
+	struct Mark {
+		size_t m_block;
+		size_t m_offset;
+	};
+	Mark getMark() const { return {m_block, m_offset}; }
+	// free everything allocated after the mark
+	void rewind(const Mark mark) {
+		m_block = mark.m_block;
+		m_offset = mark.m_offset;
+	}
+
+	// free everything. If the data didn't fit one block, the blocks are merged into one
+	// big enough for all of it (so the next gesture doesn't allocate)
+	void reset();
+
+	size_t getCapacity() const;
+
+private:
+	struct Block {
+		std::unique_ptr<std::byte[]> m_data;
+		size_t m_size;
+	};
+
+	// total size of the blocks before the given one
+	size_t getUsedBefore(const size_t block) const;
+
+	size_t m_blockSize;
+	std::vector<Block> m_blocks;
+	size_t m_block = 0;  // current block
+	size_t m_offset = 0; // used bytes of the current block
+	size_t m_used = 0;   // max bytes used since the last reset (for merging the blocks)
+};
+
+// std allocator on top of the arena, e.g. std::vector<int, ArenaAllocator<int>>.
+// deallocate() does nothing, the memory comes back when the arena is reset
+template <class T>
+class ArenaAllocator {
+public:
+	using value_type = T;
+
+	explicit ArenaAllocator(ScratchArena& arena) : m_arena(&arena) {}
+	template <class U>
+	ArenaAllocator(const ArenaAllocator<U>& o) : m_arena(o.m_arena) {}
+
+	T* allocate(const size_t count) { return m_arena->allocate<T>(count); }
+	void deallocate(T*, size_t) {}
+
+	template <class U>
+	bool operator==(const ArenaAllocator<U>& o) const { return m_arena == o.m_arena; }
+
+private:
+	template <class U> friend class ArenaAllocator;
+	ScratchArena* m_arena;
+};
+
+template <class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+} // namespace itc
@@ -0,0 +1,88 @@
+#include "SelectionBounds.hpp"
+#include <algorithm>
+
+namespace itc {
+
+namespace {
+
+void expandRect(Rect& rect, const Rect& other) {
+	rect.m_min.x = std::min(rect.m_min.x, other.m_min.x);
+	rect.m_min.y = std::min(rect.m_min.y, other.m_min.y);
+	rect.m_max.x = std::max(rect.m_max.x, other.m_max.x);
+	rect.m_max.y = std::max(rect.m_max.y, other.m_max.y);
+}
+
+bool isOnRect(const Rect& rect, const Rect& other) {
+	return other.m_min.x <= rect.m_min.x || other.m_min.y <= rect.m_min.y
+		|| other.m_max.x >= rect.m_max.x || other.m_max.y >= rect.m_max.y;
+}
+
+} // namespace
+
+void SelectionBounds::clear() {
+	m_objects.clear();
+	m_bounds = {};
+	m_positionBounds = {};
+	m_dirty = false;
+}
+
+void SelectionBounds::expand(const Object& obj) {
+	if (m_dirty) return;
+	if (m_objects.size() == 1) {
+		m_bounds = obj.m_bounds;
+		m_positionBounds = {obj.m_position, obj.m_position};
+		return;
+	}
+	expandRect(m_bounds, obj.m_bounds);
+	expandRect(m_positionBounds, {obj.m_position, obj.m_position});
+}
+
+bool SelectionBounds::isOnBounds(const Object& obj) const {
+	return isOnRect(m_bounds, obj.m_bounds) || isOnRect(m_positionBounds, {obj.m_position, obj.m_position});
+}
+
+void SelectionBounds::add(const int id, const Rect& bounds, const Vec2 position) {
+	const auto [it, inserted] = m_objects.try_emplace(id, Object{bounds, position});
+	if (!inserted) {
+		if (!m_dirty && isOnBounds(it->second)) m_dirty = true;
+		it->second = {bounds, position};
+	}
+	expand(it->second);
+}
+
+void SelectionBounds::remove(const int id) {
+	const auto it = m_objects.find(id);
+	if (it == m_objects.end()) return;
+	if (!m_dirty && isOnBounds(it->second)) m_dirty = true;
+	m_objects.erase(it);
+}
+
+void SelectionBounds::recompute() const {
+	m_dirty = false;
+	m_bounds = {};
+	m_positionBounds = {};
+	bool first = true;
+	for (const auto& [id, obj] : m_objects) {
+		const Rect position = {obj.m_position, obj.m_position};
+		if (first) {
+			m_bounds = obj.m_bounds;
+			m_positionBounds = position;
+			first = false;
+			continue;
+		}
+		expandRect(m_bounds, obj.m_bounds);
+		expandRect(m_positionBounds, position);
+	}
+}
+
+const Rect& SelectionBounds::getBounds() const {
+	if (m_dirty) recompute();
+	return m_bounds;
+}
+
+const Rect& SelectionBounds::getPositionBounds() const {
+	if (m_dirty) recompute();
+	return m_positionBounds;
+}
+
+} // namespace itc
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <unordered_map>
+#include "Geometry.hpp"
+
+namespace itc {
+
+// Bounds of the selected objects kept up to date while the selection changes, so growing
+// a big selection object by object doesn't rescan it. Adding an object only expands the
+// bounds. Removing or moving an object that lies on the bounds marks them for one lazy
+// recompute (from the stored rects, no objects are touched)
+class SelectionBounds {
+public:
+	void clear();
+	size_t size() const { return m_objects.size(); }
+	bool contains(const int id) const { return m_objects.count(id) != 0; }
+
+	// insert or update the object (bounds and position in object layer coords)
+	void add(const int id, const Rect& bounds, const Vec2 position);
+	void remove(const int id);
+
+	// union of the object bounds
+	const Rect& getBounds() const;
+	// bounds of the object positions, their center is the center RobTop's code uses
+	const Rect& getPositionBounds() const;
+	Vec2 getCenter() const { return getPositionBounds().center(); }
+
+private:
+	struct Object {
+		Rect m_bounds;
+		Vec2 m_position;
+	};
+
+	void expand(const Object& obj);
+	// true if the object defines one of the sides of the bounds
+	bool isOnBounds(const Object& obj) const;
+	void recompute() const;
+
+	std::unordered_map<int, Object> m_objects;
+	mutable Rect m_bounds;
+	mutable Rect m_positionBounds;
+	mutable bool m_dirty = false;
+};
+
+} // namespace itc
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+namespace itc {
+
+// Hash of a set of objects and their transforms. Objects are combined with a sum,
+// so the order of the selection doesn't matter and objects can be added and removed
+// one by one (the part of an object must be removed with the same value it was added)
+class SelectionKey {
+public:
+	// part of the key for one object
+	static uint64_t hashObject(const int id, const float x, const float y, const float rotX, const float rotY,
+								const float scaleX, const float scaleY) {
+		uint64_t h = mix((uint64_t)(uint32_t)id);
+		for (const float v : {x, y, rotX, rotY, scaleX, scaleY}) {
+			uint32_t bits;
+			std::memcpy(&bits, &v, sizeof(bits));
+			h = mix(h ^ bits);
+		}
+		return h;
+	}
+
+	void add(const uint64_t part) {
+		m_sum += part;
+		m_count++;
+	}
+
+	void remove(const uint64_t part) {
+		m_sum -= part;
+		m_count--;
+	}
+
+	void clear() {
+		m_sum = 0;
+		m_count = 0;
+	}
+
+	uint64_t get() const { return mix(m_sum ^ m_count); }
+	uint64_t getCount() const { return m_count; }
+
+private:
+	// splitmix64 finalizer
+	static uint64_t mix(uint64_t x) {
+		x ^= x >> 30;
+		x *= 0xbf58476d1ce4e5b9ull;
+		x ^= x >> 27;
+		x *= 0x94d049bb133111ebull;
+		x ^= x >> 31;
+		return x;
+	}
+
+	uint64_t m_sum = 0;
+	uint64_t m_count = 0;
+};
+
+} // namespace itc
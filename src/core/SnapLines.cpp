@@ -0,0 +1,115 @@
+#include "SnapLines.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace itc {
+
+void GuideLines::clear() {
+	m_lines[Vertical].clear();
+	m_lines[Horizontal].clear();
+	m_version++;
+}
+
+bool GuideLines::add(const LineAxis axis, const float pos, const float maxError) {
+	float nearest;
+	if (findNearest(axis, pos, maxError, &nearest)) return false;
+	auto& lines = m_lines[axis];
+	lines.insert(std::lower_bound(lines.begin(), lines.end(), pos), pos);
+	m_version++;
+	return true;
+}
+
+bool GuideLines::remove(const LineAxis axis, const float pos, const float maxError) {
+	float nearest;
+	if (!findNearest(axis, pos, maxError, &nearest)) return false;
+	auto& lines = m_lines[axis];
+	lines.erase(std::lower_bound(lines.begin(), lines.end(), nearest));
+	m_version++;
+	return true;
+}
+
+bool GuideLines::findNearest(const LineAxis axis, const float pos, const float limit, float* const nearest) const {
+	const auto& lines = m_lines[axis];
+	// only the lines on both sides of pos can be the closest
+	const auto it = std::lower_bound(lines.begin(), lines.end(), pos);
+	float bestDist = limit;
+	bool found = false;
+	if (it != lines.end() && *it - pos <= bestDist) {
+		bestDist = *it - pos;
+		*nearest = *it;
+		found = true;
+	}
+	if (it != lines.begin() && pos - *(it - 1) <= bestDist) {
+		*nearest = *(it - 1);
+		found = true;
+	}
+	return found;
+}
+
+std::pair<const float*, const float*> GuideLines::getRange(const LineAxis axis, const float min, const float max) const {
+	const auto& lines = m_lines[axis];
+	const auto begin = std::lower_bound(lines.begin(), lines.end(), min);
+	const auto end = std::upper_bound(begin, lines.end(), max);
+	return {lines.data() + (begin - lines.begin()), lines.data() + (end - lines.begin())};
+}
+
+bool SnapLines::findNearest(const LineAxis axis, const float pos, const float limit, float* const nearest) const {
+	float bestDist = limit;
+	bool found = false;
+	if (m_gridStep > 0) {
+		const float line = std::round(pos / m_gridStep) * m_gridStep;
+		if (std::abs(line - pos) <= bestDist) {
+			bestDist = std::abs(line - pos);
+			*nearest = line;
+			found = true;
+		}
+	}
+	// guides go first if they're as close as the grid
+	if (m_guides && m_guides->findNearest(axis, pos, bestDist, nearest)) found = true;
+	return found;
+}
+
+uint8_t SnapLines::snapPoint(const Vec2 p, const float limit, Vec2* const snapped) const {
+	*snapped = p;
+	uint8_t axes = 0;
+	if (findNearest(Vertical, p.x, limit, &snapped->x)) axes |= 1 << Vertical;
+	if (findNearest(Horizontal, p.y, limit, &snapped->y)) axes |= 1 << Horizontal;
+	return axes;
+}
+
+bool SnapLines::snapOnLine(const Vec2 p, const Vec2 dir, const float limit, Vec2* const snapped) const {
+	const float length = std::sqrt(dir.lengthSq());
+	if (length == 0) return false;
+	const Vec2 d = dir / length;
+	// p + d * t crosses the line x = pos at t = (pos - p.x) / d.x, so the closest crossing
+	// with the vertical lines is at the line closest to p.x (same for y)
+	float bestT = 0;
+	bool found = false;
+	const float comps[2] = {d.x, d.y};
+	const float coords[2] = {p.x, p.y};
+	for (const auto axis : {Vertical, Horizontal}) {
+		const float k = std::abs(comps[axis]);
+		// (almost) parallel to the lines of this axis
+		if (k < 1e-3f) continue;
+		const float maxDist = (found ? std::abs(bestT) : limit) * k;
+		float pos;
+		if (!findNearest(axis, coords[axis], maxDist, &pos)) continue;
+		const float t = (pos - coords[axis]) / comps[axis];
+		if (!found || std::abs(t) < std::abs(bestT)) {
+			bestT = t;
+			found = true;
+		}
+	}
+	if (found) *snapped = p + d * bestT;
+	return found;
+}
+
+bool SnapLines::snapNearLine(const Vec2 p, const Vec2 origin, const Vec2 dir, const float limit, Vec2* const snapped) const {
+	const float lengthSq = dir.lengthSq();
+	if (lengthSq == 0) return false;
+	const Vec2 projected = origin + dir * ((p - origin).dot(dir) / lengthSq);
+	if ((p - projected).lengthSq() > limit * limit) return false;
+	return snapOnLine(projected, dir, limit, snapped);
+}
+
+} // namespace itc
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Geometry.hpp"
+
+// Snapping to the editor grid and to guide lines (in level coords). The closest grid line
+// is found by rounding and the closest guide by a binary search, so a snap costs the same
+// no matter how dense the grid is or how many guides there are
+
+namespace itc {
+
+// one block of the editor
+constexpr float GRID_SIZE = 30;
+
+// axes of the lines: vertical lines are x = pos, horizontal ones are y = pos
+enum LineAxis : uint8_t {
+	Vertical,
+	Horizontal,
+};
+
+// Guide lines placed by the user, kept sorted
+class GuideLines {
+public:
+	void clear();
+	bool empty() const { return m_lines[Vertical].empty() && m_lines[Horizontal].empty(); }
+	// incremented on every change (to let the overlay know it has to be rebuilt)
+	uint32_t getVersion() const { return m_version; }
+
+	const std::vector<float>& getLines(const LineAxis axis) const { return m_lines[axis]; }
+
+	// returns false if there's already a line within maxError
+	bool add(const LineAxis axis, const float pos, const float maxError);
+	// remove the closest line within maxError, returns false if there's none
+	bool remove(const LineAxis axis, const float pos, const float maxError);
+
+	// return true and set nearest if there's a line within limit
+	bool findNearest(const LineAxis axis, const float pos, const float limit, float* const nearest) const;
+
+	// sorted lines in [min, max]
+	std::pair<const float*, const float*> getRange(const LineAxis axis, const float min, const float max) const;
+
+private:
+	std::vector<float> m_lines[2];
+	uint32_t m_version = 0;
+};
+
+// Lines something can snap to: the grid and the guides
+struct SnapLines {
+	float m_gridStep = 0; // 0 - no grid
+	const GuideLines* m_guides = nullptr;
+
+	bool empty() const { return m_gridStep <= 0 && (!m_guides || m_guides->empty()); }
+
+	// return true and set nearest if there's a line within limit (the closest of the grid and the guides)
+	bool findNearest(const LineAxis axis, const float pos, const float limit, float* const nearest) const;
+
+	// Point that moves freely (the anchor): every axis snaps on its own, so the point ends up
+	// on a line or on the crossing of two. Returns the snapped axes (bit 1 << LineAxis)
+	uint8_t snapPoint(const Vec2 p, const float limit, Vec2* const snapped) const;
+
+	// Point that can only move along the line through p with the direction dir (the side handles
+	// of the controls, dir is their axis in the rotated frame): the closest crossing of that
+	// line with a snap line, if it's within limit along the line
+	bool snapOnLine(const Vec2 p, const Vec2 dir, const float limit, Vec2* const snapped) const;
+
+	// Same, for a point on the line through origin with the direction dir that p can only
+	// be near (the corner handles, dir is their diagonal through the anchor): p is projected
+	// on the line first, nothing snaps if it's farther than limit from it
+	bool snapNearLine(const Vec2 p, const Vec2 origin, const Vec2 dir, const float limit, Vec2* const snapped) const;
+};
+
+// grid step of the subdivision (0 - blocks, 1 - half blocks...)
+inline float getGridStep(const int subdivision) {
+	return GRID_SIZE / (float)(1 << subdivision);
+}
+
+} // namespace itc
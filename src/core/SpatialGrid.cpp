@@ -0,0 +1,58 @@
+#include "SpatialGrid.hpp"
+
+namespace itc {
+
+void SpatialGrid::getSnapPoints(const Rect& bounds, Vec2 (&points)[SNAP_POINTS]) {
+	points[0] = bounds.m_min;
+	points[1] = {bounds.m_max.x, bounds.m_min.y};
+	points[2] = bounds.m_max;
+	points[3] = {bounds.m_min.x, bounds.m_max.y};
+	points[4] = bounds.center();
+}
+
+void SpatialGrid::clear() {
+	m_cells.clear();
+	m_objects.clear();
+}
+
+void SpatialGrid::update(const int id, const Rect& bounds) {
+	auto [it, inserted] = m_objects.try_emplace(id, bounds);
+	if (!inserted) {
+		if (it->second == bounds) return; // didn't move
+		removePoints(id, it->second);
+		it->second = bounds;
+	}
+	Vec2 points[SNAP_POINTS];
+	getSnapPoints(bounds, points);
+	for (const auto& p : points) {
+		m_cells[cellKeyFor(p)].push_back({p, id});
+	}
+}
+
+void SpatialGrid::remove(const int id) {
+	const auto it = m_objects.find(id);
+	if (it == m_objects.end()) return;
+	removePoints(id, it->second);
+	m_objects.erase(it);
+}
+
+void SpatialGrid::removePoints(const int id, const Rect& bounds) {
+	Vec2 points[SNAP_POINTS];
+	getSnapPoints(bounds, points);
+	for (const auto& p : points) {
+		const auto cell = m_cells.find(cellKeyFor(p));
+		if (cell == m_cells.end()) continue;
+		auto& vec = cell->second;
+		// several points of the object can share the cell, remove one per call
+		for (size_t i = 0; i < vec.size(); i++) {
+			if (vec[i].m_id == id) {
+				vec[i] = vec.back();
+				vec.pop_back();
+				break;
+			}
+		}
+		if (vec.empty()) m_cells.erase(cell);
+	}
+}
+
+} // namespace itc
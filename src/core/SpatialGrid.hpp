@@ -0,0 +1,71 @@
+#pragma once
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+#include "Geometry.hpp"
+
+namespace itc {
+
+// Uniform grid of object snap points (4 corners and the center of the object bounds).
+// Objects are added / moved / removed one by one, so the grid can be kept up to date
+// while editing instead of scanning the whole level on every touch.
+class SpatialGrid {
+public:
+	explicit SpatialGrid(const float cellSize = 120.f) : m_cellSize(cellSize) {}
+
+	void clear();
+	size_t size() const { return m_objects.size(); }
+	bool contains(const int id) const { return m_objects.count(id) != 0; }
+
+	// insert or move the object
+	void update(const int id, const Rect& bounds);
+	void remove(const int id);
+
+	// find the closest snap point within radius, skip objects for which skip(id) is true.
+	// only the cells covered by the radius are visited
+	template <class Skip>
+	bool queryNearest(const Vec2 pos, const float radius, Skip&& skip, Vec2* const snapPos, int* const snapId) const {
+		const int x0 = cellCoord(pos.x - radius), x1 = cellCoord(pos.x + radius);
+		const int y0 = cellCoord(pos.y - radius), y1 = cellCoord(pos.y + radius);
+		float bestDistSq = radius * radius;
+		bool found = false;
+		for (int x = x0; x <= x1; x++) {
+			for (int y = y0; y <= y1; y++) {
+				const auto cell = m_cells.find(cellKey(x, y));
+				if (cell == m_cells.end()) continue;
+				for (const auto& point : cell->second) {
+					const float distSq = (point.m_pos - pos).lengthSq();
+					if (distSq < bestDistSq && !skip(point.m_id)) {
+						bestDistSq = distSq;
+						*snapPos = point.m_pos;
+						*snapId = point.m_id;
+						found = true;
+					}
+				}
+			}
+		}
+		return found;
+	}
+
+	// corners and center
+	static constexpr int SNAP_POINTS = 5;
+	static void getSnapPoints(const Rect& bounds, Vec2 (&points)[SNAP_POINTS]);
+
+private:
+	struct Point {
+		Vec2 m_pos;
+		int m_id;
+	};
+
+	int cellCoord(const float v) const { return (int)std::floor(v / m_cellSize); }
+	static int64_t cellKey(const int x, const int y) { return ((int64_t)x << 32) | (uint32_t)y; }
+	int64_t cellKeyFor(const Vec2 p) const { return cellKey(cellCoord(p.x), cellCoord(p.y)); }
+
+	void removePoints(const int id, const Rect& bounds);
+
+	float m_cellSize;
+	std::unordered_map<int64_t, std::vector<Point>> m_cells;
+	std::unordered_map<int, Rect> m_objects; // id -> bounds that are currently in the grid
+};
+
+} // namespace itc
@@ -0,0 +1,63 @@
+#include "TransformFrame.hpp"
+#include <cmath>
+#include "HandleTopology.hpp"
+
+namespace itc {
+
+constexpr double DEG_TO_RAD = 3.14159265358979323846 / 180.0;
+
+void TransformFrame::rebuild(const HandlePositions& handles, const float rotation) {
+	m_handles = handles;
+	m_rotation = rotation;
+	m_sin = float(std::sin(rotation * DEG_TO_RAD));
+	m_cos = float(std::cos(rotation * DEG_TO_RAD));
+	m_center = (handles.m_pos[7] + handles.m_pos[8]) / 2.f;
+
+	// vertices cw
+	const Vec2 v[] = {handles.m_pos[6], handles.m_pos[7], handles.m_pos[9], handles.m_pos[8]};
+	for (int A = 3, B = 0; B < 4; A = B++) {
+		const auto AB = v[B] - v[A];
+		Vec2 normal;
+		if (std::abs(AB.x) > std::abs(AB.y)) {
+			normal = {-AB.y / AB.x, 1.f};
+		} else {
+			normal = {1.f, -AB.x / AB.y};
+		}
+		m_edgeNormals[B] = normal;
+		m_edgeOffsets[B] = normal.dot(v[A]);
+	}
+	m_valid = true;
+	m_version++;
+}
+
+bool TransformFrame::checkAnchorSnaps(const float limit, const Vec2 anchor, Vec2* const snapCoords,
+										uint8_t* const spriteIndex, const bool checkCenter) const {
+	const auto anchorRelPos = toLocal(anchor);
+	const float limitSq = limit * limit;
+	for (const auto& handle : HANDLES) {
+		const bool isCenter = handle.m_tag == ANCHOR_TAG;
+		if (isCenter && !checkCenter) continue;
+		const auto pos = isCenter ? m_center : m_handles.m_pos[handle.m_tag];
+		if ((anchorRelPos - pos).lengthSq() < limitSq) {
+			*snapCoords = fromLocal(pos);
+			*spriteIndex = handle.m_tag;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool TransformFrame::checkAnchorIsOnEdge(const float limit, const Vec2 anchor,
+											uint8_t* const spriteIndex) const {
+	const auto C = toLocal(anchor);
+	uint8_t alignedEdges = 0;
+	for (int B = 0; B < EDGE_COUNT; B++) {
+		alignedEdges |= std::abs(m_edgeNormals[B].dot(C) - m_edgeOffsets[B]) < limit ? edgeBit(B) : 0;
+	}
+	const uint8_t tag = HANDLE_BY_EDGES[alignedEdges];
+	if (!tag) return false;
+	*spriteIndex = tag;
+	return true;
+}
+
+} // namespace itc
@@ -0,0 +1,50 @@
+#pragma once
+#include "Geometry.hpp"
+
+namespace itc {
+
+// Cached oriented rectangle of the transform controls.
+// Holds the handle positions, the rotation matrix of m_mainNode and the edge lines
+// (in m_mainNode coords), so that snap and alignment checks during the gesture are
+// just a few multiplications and compares. It must be rebuilt when the rect or the
+// rotation changes (see MyGJTransformControl::getFrame())
+class TransformFrame {
+public:
+	void rebuild(const HandlePositions& handles, const float rotation);
+	void invalidate() { m_valid = false; }
+
+	// is the frame up to date for the given rotation
+	bool isValidFor(const float rotation) const { return m_valid && rotation == m_rotation; }
+	// incremented on every rebuild (to let other nodes know the handles moved)
+	uint32_t getVersion() const { return m_version; }
+
+	const HandlePositions& getHandles() const { return m_handles; }
+	float getRotation() const { return m_rotation; }
+
+	// transform control coords <-> m_mainNode coords
+	Vec2 toLocal(const Vec2 p) const { return {m_cos * p.x - m_sin * p.y, m_sin * p.x + m_cos * p.y}; }
+	Vec2 fromLocal(const Vec2 p) const { return {m_cos * p.x + m_sin * p.y, -m_sin * p.x + m_cos * p.y}; }
+
+	// same as itc::checkAnchorSnaps() but uses the cached data
+	bool checkAnchorSnaps(const float limit, const Vec2 anchor, Vec2* const snapCoords,
+							uint8_t* const spriteIndex, const bool checkCenter) const;
+
+	// same as itc::checkAnchorIsOnEdge() but uses the cached data
+	bool checkAnchorIsOnEdge(const float limit, const Vec2 anchor, uint8_t* const spriteIndex) const;
+
+private:
+	bool m_valid = false;
+	uint32_t m_version = 0;
+	float m_rotation = 0;
+	float m_sin = 0;
+	float m_cos = 1;
+	HandlePositions m_handles;
+	Vec2 m_center;
+	// edges are stored as lines (n.p == offset) in clockwise order starting from the left one.
+	// normals aren't unit: the bigger component is 1, so n.p - offset gives the vertical
+	// (or horizontal) distance to the edge, same as the slope based check used to do
+	Vec2 m_edgeNormals[4];
+	float m_edgeOffsets[4] = {};
+};
+
+} // namespace itc
@@ -0,0 +1,53 @@
+#include "TransformHistory.hpp"
+
+namespace itc {
+
+void TransformHistory::clear() {
+	m_undo.clear();
+	m_redo.clear();
+}
+
+bool TransformHistory::canMerge(const std::vector<int>& ids, const int lastMarker, const double time) const {
+	if (m_undo.empty()) return false;
+	const auto& last = m_undo.back();
+	return last.m_marker == lastMarker && time - last.m_time < MERGE_WINDOW && last.m_ids == ids;
+}
+
+int TransformHistory::push(std::vector<int>&& ids, const ObjectTransform& transform,
+								const int marker, const double time) {
+	m_redo.clear();
+	if (canMerge(ids, marker, time)) {
+		auto& last = m_undo.back();
+		last.m_transform = last.m_transform.then(transform);
+		last.m_time = time;
+		return 0;
+	}
+	m_undo.push_back({std::move(ids), transform, marker, time});
+	if (m_undo.size() <= MAX_RECORDS) return 0;
+	const int dropped = m_undo.front().m_marker;
+	m_undo.pop_front();
+	return dropped;
+}
+
+const TransformRecord* TransformHistory::undo(const int marker) {
+	if (m_undo.empty() || m_undo.back().m_marker != marker) return nullptr;
+	m_redo.push_back(std::move(m_undo.back()));
+	m_undo.pop_back();
+	return &m_redo.back();
+}
+
+const TransformRecord* TransformHistory::redo(const int marker) {
+	if (m_redo.empty() || m_redo.back().m_marker != marker) return nullptr;
+	m_undo.push_back(std::move(m_redo.back()));
+	m_redo.pop_back();
+	return &m_undo.back();
+}
+
+size_t TransformHistory::getMemoryUsage() const {
+	size_t size = 0;
+	for (const auto& record : m_undo) size += sizeof(record) + record.m_ids.capacity() * sizeof(int);
+	for (const auto& record : m_redo) size += sizeof(record) + record.m_ids.capacity() * sizeof(int);
+	return size;
+}
+
+} // namespace itc
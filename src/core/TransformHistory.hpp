@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include "TransformKernel.hpp"
+
+namespace itc {
+
+// one undo entry: which objects were transformed and how (instead of a copy of every object)
+struct TransformRecord {
+	std::vector<int> m_ids; // sorted object ids
+	ObjectTransform m_transform;
+	int m_marker = 0;  // marker of the record in the editor undo list
+	double m_time = 0; // when the record was made or merged (seconds)
+};
+
+// Compact undo/redo history of transform gestures. It lives next to the editor undo list:
+// every record has a marker there (an entry with a unique tag), and it's undone / redone
+// only when its marker is the next entry of the editor list
+class TransformHistory {
+public:
+	static constexpr size_t MAX_RECORDS = 200;
+	// gestures on the same objects within this time are merged into one record
+	static constexpr double MERGE_WINDOW = 1.5;
+
+	void clear();
+
+	// true if a record done on the objects (sorted ids) would be merged into the last one:
+	// same objects, right after it (marker is the last entry of the editor undo list)
+	bool canMerge(const std::vector<int>& ids, const int lastMarker, const double time) const;
+	// add a record (ids must be sorted), or merge it into the last one (see canMerge()).
+	// Clears the redo history. Returns the marker of the oldest record if it was dropped
+	// to stay under MAX_RECORDS (its entry must be removed from the editor list), or 0
+	int push(std::vector<int>&& ids, const ObjectTransform& transform, const int marker, const double time);
+
+	// record to undo if the marker (last entry of the editor undo list) is its marker,
+	// it's moved to the redo history. nullptr if the last action isn't ours
+	const TransformRecord* undo(const int marker);
+	// record to redo if the marker (last entry of the editor redo list) is its marker,
+	// it's moved back to the undo history. nullptr if the next action isn't ours
+	const TransformRecord* redo(const int marker);
+
+	size_t getUndoCount() const { return m_undo.size(); }
+	size_t getRedoCount() const { return m_redo.size(); }
+	// approximate memory used by the records
+	size_t getMemoryUsage() const;
+
+private:
+	std::deque<TransformRecord> m_undo;
+	std::vector<TransformRecord> m_redo;
+};
+
+} // namespace itc
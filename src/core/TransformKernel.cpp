@@ -0,0 +1,161 @@
+#include "TransformKernel.hpp"
+#include "WorkerPool.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define ITC_SSE2 1
+	#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define ITC_NEON 1
+	#include <arm_neon.h>
+#endif
+
+namespace itc {
+
+void ObjectBuffer::resize(const size_t count) {
+	m_x.resize(count);
+	m_y.resize(count);
+	m_rotX.resize(count);
+	m_rotY.resize(count);
+	m_scaleX.resize(count);
+	m_scaleY.resize(count);
+}
+
+void applyTransformScalar(const ObjectBuffer& src, ObjectBuffer& dst, const ObjectTransform& transform,
+							const size_t begin, const size_t end) {
+	const auto& m = transform.m_matrix;
+	const float sign = transform.rotationSign();
+	for (size_t i = begin; i < end; i++) {
+		const float x = src.m_x[i], y = src.m_y[i];
+		dst.m_x[i] = m.a * x + m.c * y + m.tx;
+		dst.m_y[i] = m.b * x + m.d * y + m.ty;
+		dst.m_rotX[i] = src.m_rotX[i] * sign + transform.m_rotX;
+		dst.m_rotY[i] = src.m_rotY[i] * sign + transform.m_rotY;
+		dst.m_scaleX[i] = src.m_scaleX[i] * transform.m_scaleX;
+		dst.m_scaleY[i] = src.m_scaleY[i] * transform.m_scaleY;
+	}
+}
+
+void applyTransformSimd(const ObjectBuffer& src, ObjectBuffer& dst, const ObjectTransform& transform,
+							const size_t begin, const size_t end) {
+	size_t i = begin;
+#if defined(ITC_SSE2)
+	const auto& m = transform.m_matrix;
+	const __m128 a = _mm_set1_ps(m.a), b = _mm_set1_ps(m.b), c = _mm_set1_ps(m.c), d = _mm_set1_ps(m.d);
+	const __m128 tx = _mm_set1_ps(m.tx), ty = _mm_set1_ps(m.ty);
+	const __m128 rotX = _mm_set1_ps(transform.m_rotX), rotY = _mm_set1_ps(transform.m_rotY);
+	const __m128 sign = _mm_set1_ps(transform.rotationSign());
+	const __m128 scaleX = _mm_set1_ps(transform.m_scaleX), scaleY = _mm_set1_ps(transform.m_scaleY);
+	for (; i + 4 <= end; i += 4) {
+		const __m128 x = _mm_loadu_ps(&src.m_x[i]);
+		const __m128 y = _mm_loadu_ps(&src.m_y[i]);
+		// same order of operations as the scalar version
+		_mm_storeu_ps(&dst.m_x[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, x), _mm_mul_ps(c, y)), tx));
+		_mm_storeu_ps(&dst.m_y[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(b, x), _mm_mul_ps(d, y)), ty));
+		_mm_storeu_ps(&dst.m_rotX[i], _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&src.m_rotX[i]), sign), rotX));
+		_mm_storeu_ps(&dst.m_rotY[i], _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&src.m_rotY[i]), sign), rotY));
+		_mm_storeu_ps(&dst.m_scaleX[i], _mm_mul_ps(_mm_loadu_ps(&src.m_scaleX[i]), scaleX));
+		_mm_storeu_ps(&dst.m_scaleY[i], _mm_mul_ps(_mm_loadu_ps(&src.m_scaleY[i]), scaleY));
+	}
+#elif defined(ITC_NEON)
+	const auto& m = transform.m_matrix;
+	const float32x4_t a = vdupq_n_f32(m.a), b = vdupq_n_f32(m.b), c = vdupq_n_f32(m.c), d = vdupq_n_f32(m.d);
+	const float32x4_t tx = vdupq_n_f32(m.tx), ty = vdupq_n_f32(m.ty);
+	const float32x4_t rotX = vdupq_n_f32(transform.m_rotX), rotY = vdupq_n_f32(transform.m_rotY);
+	const float32x4_t sign = vdupq_n_f32(transform.rotationSign());
+	const float32x4_t scaleX = vdupq_n_f32(transform.m_scaleX), scaleY = vdupq_n_f32(transform.m_scaleY);
+	for (; i + 4 <= end; i += 4) {
+		const float32x4_t x = vld1q_f32(&src.m_x[i]);
+		const float32x4_t y = vld1q_f32(&src.m_y[i]);
+		// same order of operations as the scalar version (no fused multiply-add)
+		vst1q_f32(&dst.m_x[i], vaddq_f32(vaddq_f32(vmulq_f32(a, x), vmulq_f32(c, y)), tx));
+		vst1q_f32(&dst.m_y[i], vaddq_f32(vaddq_f32(vmulq_f32(b, x), vmulq_f32(d, y)), ty));
+		vst1q_f32(&dst.m_rotX[i], vaddq_f32(vmulq_f32(vld1q_f32(&src.m_rotX[i]), sign), rotX));
+		vst1q_f32(&dst.m_rotY[i], vaddq_f32(vmulq_f32(vld1q_f32(&src.m_rotY[i]), sign), rotY));
+		vst1q_f32(&dst.m_scaleX[i], vmulq_f32(vld1q_f32(&src.m_scaleX[i]), scaleX));
+		vst1q_f32(&dst.m_scaleY[i], vmulq_f32(vld1q_f32(&src.m_scaleY[i]), scaleY));
+	}
+#endif
+	applyTransformScalar(src, dst, transform, i, end);
+}
+
+void applyTransformParallel(const ObjectBuffer& src, ObjectBuffer& dst, const ObjectTransform& transform,
+							WorkerPool& pool) {
+	// chunks aligned to the vector width: the same objects go through the scalar tail
+	pool.parallelFor(src.size(), 4, [&](size_t begin, size_t end) {
+		applyTransformSimd(src, dst, transform, begin, end);
+	});
+}
+
+void applyPivotTransformScalar(const ObjectBuffer& src, const float* pivotX, const float* pivotY,
+								ObjectBuffer& dst, const ObjectTransform& transform, const Vec2 move,
+								const size_t begin, const size_t end) {
+	const auto& m = transform.m_matrix;
+	const float sign = transform.rotationSign();
+	for (size_t i = begin; i < end; i++) {
+		const float x = src.m_x[i] - pivotX[i], y = src.m_y[i] - pivotY[i];
+		dst.m_x[i] = (m.a * x + m.c * y) + (pivotX[i] + move.x);
+		dst.m_y[i] = (m.b * x + m.d * y) + (pivotY[i] + move.y);
+		dst.m_rotX[i] = src.m_rotX[i] * sign + transform.m_rotX;
+		dst.m_rotY[i] = src.m_rotY[i] * sign + transform.m_rotY;
+		dst.m_scaleX[i] = src.m_scaleX[i] * transform.m_scaleX;
+		dst.m_scaleY[i] = src.m_scaleY[i] * transform.m_scaleY;
+	}
+}
+
+void applyPivotTransformSimd(const ObjectBuffer& src, const float* pivotX, const float* pivotY,
+								ObjectBuffer& dst, const ObjectTransform& transform, const Vec2 move,
+								const size_t begin, const size_t end) {
+	size_t i = begin;
+#if defined(ITC_SSE2)
+	const auto& m = transform.m_matrix;
+	const __m128 a = _mm_set1_ps(m.a), b = _mm_set1_ps(m.b), c = _mm_set1_ps(m.c), d = _mm_set1_ps(m.d);
+	const __m128 moveX = _mm_set1_ps(move.x), moveY = _mm_set1_ps(move.y);
+	const __m128 rotX = _mm_set1_ps(transform.m_rotX), rotY = _mm_set1_ps(transform.m_rotY);
+	const __m128 sign = _mm_set1_ps(transform.rotationSign());
+	const __m128 scaleX = _mm_set1_ps(transform.m_scaleX), scaleY = _mm_set1_ps(transform.m_scaleY);
+	for (; i + 4 <= end; i += 4) {
+		const __m128 px = _mm_loadu_ps(&pivotX[i]);
+		const __m128 py = _mm_loadu_ps(&pivotY[i]);
+		const __m128 x = _mm_sub_ps(_mm_loadu_ps(&src.m_x[i]), px);
+		const __m128 y = _mm_sub_ps(_mm_loadu_ps(&src.m_y[i]), py);
+		// same order of operations as the scalar version
+		_mm_storeu_ps(&dst.m_x[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, x), _mm_mul_ps(c, y)), _mm_add_ps(px, moveX)));
+		_mm_storeu_ps(&dst.m_y[i], _mm_add_ps(_mm_add_ps(_mm_mul_ps(b, x), _mm_mul_ps(d, y)), _mm_add_ps(py, moveY)));
+		_mm_storeu_ps(&dst.m_rotX[i], _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&src.m_rotX[i]), sign), rotX));
+		_mm_storeu_ps(&dst.m_rotY[i], _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&src.m_rotY[i]), sign), rotY));
+		_mm_storeu_ps(&dst.m_scaleX[i], _mm_mul_ps(_mm_loadu_ps(&src.m_scaleX[i]), scaleX));
+		_mm_storeu_ps(&dst.m_scaleY[i], _mm_mul_ps(_mm_loadu_ps(&src.m_scaleY[i]), scaleY));
+	}
+#elif defined(ITC_NEON)
+	const auto& m = transform.m_matrix;
+	const float32x4_t a = vdupq_n_f32(m.a), b = vdupq_n_f32(m.b), c = vdupq_n_f32(m.c), d = vdupq_n_f32(m.d);
+	const float32x4_t moveX = vdupq_n_f32(move.x), moveY = vdupq_n_f32(move.y);
+	const float32x4_t rotX = vdupq_n_f32(transform.m_rotX), rotY = vdupq_n_f32(transform.m_rotY);
+	const float32x4_t sign = vdupq_n_f32(transform.rotationSign());
+	const float32x4_t scaleX = vdupq_n_f32(transform.m_scaleX), scaleY = vdupq_n_f32(transform.m_scaleY);
+	for (; i + 4 <= end; i += 4) {
+		const float32x4_t px = vld1q_f32(&pivotX[i]);
+		const float32x4_t py = vld1q_f32(&pivotY[i]);
+		const float32x4_t x = vsubq_f32(vld1q_f32(&src.m_x[i]), px);
+		const float32x4_t y = vsubq_f32(vld1q_f32(&src.m_y[i]), py);
+		// same order of operations as the scalar version (no fused multiply-add)
+		vst1q_f32(&dst.m_x[i], vaddq_f32(vaddq_f32(vmulq_f32(a, x), vmulq_f32(c, y)), vaddq_f32(px, moveX)));
+		vst1q_f32(&dst.m_y[i], vaddq_f32(vaddq_f32(vmulq_f32(b, x), vmulq_f32(d, y)), vaddq_f32(py, moveY)));
+		vst1q_f32(&dst.m_rotX[i], vaddq_f32(vmulq_f32(vld1q_f32(&src.m_rotX[i]), sign), rotX));
+		vst1q_f32(&dst.m_rotY[i], vaddq_f32(vmulq_f32(vld1q_f32(&src.m_rotY[i]), sign), rotY));
+		vst1q_f32(&dst.m_scaleX[i], vmulq_f32(vld1q_f32(&src.m_scaleX[i]), scaleX));
+		vst1q_f32(&dst.m_scaleY[i], vmulq_f32(vld1q_f32(&src.m_scaleY[i]), scaleY));
+	}
+#endif
+	applyPivotTransformScalar(src, pivotX, pivotY, dst, transform, move, i, end);
+}
+
+void applyPivotTransformParallel(const ObjectBuffer& src, const float* pivotX, const float* pivotY,
+									ObjectBuffer& dst, const ObjectTransform& transform, const Vec2 move,
+									WorkerPool& pool) {
+	pool.parallelFor(src.size(), 4, [&](size_t begin, size_t end) {
+		applyPivotTransformSimd(src, pivotX, pivotY, dst, transform, move, begin, end);
+	});
+}
+
+} // namespace itc
@@ -0,0 +1,83 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "Affine.hpp"
+
+namespace itc {
+
+// Structure-of-arrays copy of the transform related state of objects
+struct ObjectBuffer {
+	std::vector<float> m_x, m_y;
+	std::vector<float> m_rotX, m_rotY;
+	std::vector<float> m_scaleX, m_scaleY;
+
+	size_t size() const { return m_x.size(); }
+	void resize(const size_t count);
+	void clear() { resize(0); }
+};
+
+// Change of the objects made by a transform: positions are transformed by the matrix,
+// rotation of the objects is increased by the rotation and scale is multiplied by the scale.
+// A mirror toggles the flip of the objects and negates their rotation before the increase
+struct ObjectTransform {
+	Affine m_matrix;
+	float m_rotX = 0, m_rotY = 0;
+	float m_scaleX = 1, m_scaleY = 1;
+	bool m_flipX = false, m_flipY = false;
+
+	// -1 if the rotation of the objects is negated (mirrored once)
+	float rotationSign() const { return m_flipX != m_flipY ? -1.f : 1.f; }
+
+	// this transform followed by next
+	ObjectTransform then(const ObjectTransform& next) const {
+		const float sign = next.rotationSign();
+		return {next.m_matrix * m_matrix, m_rotX * sign + next.m_rotX, m_rotY * sign + next.m_rotY,
+			m_scaleX * next.m_scaleX, m_scaleY * next.m_scaleY,
+			m_flipX != next.m_flipX, m_flipY != next.m_flipY};
+	}
+
+	ObjectTransform inverse() const {
+		const float sign = rotationSign();
+		return {m_matrix.inverse(), -m_rotX * sign, -m_rotY * sign, 1.f / m_scaleX, 1.f / m_scaleY,
+			m_flipX, m_flipY};
+	}
+};
+
+// dst[i] = transform(src[i]) for i in [begin, end), dst must have the same size as src
+void applyTransformScalar(const ObjectBuffer& src, ObjectBuffer& dst, const ObjectTransform& transform,
+							const size_t begin, const size_t end);
+
+// same as applyTransformScalar() but uses SSE2 / NEON when available
+void applyTransformSimd(const ObjectBuffer& src, ObjectBuffer& dst, const ObjectTransform& transform,
+							const size_t begin, const size_t end);
+
+class WorkerPool;
+
+// applyTransformSimd() split across the threads of the pool.
+// Every object is computed independently, so the result doesn't depend on the thread count
+void applyTransformParallel(const ObjectBuffer& src, ObjectBuffer& dst, const ObjectTransform& transform,
+							WorkerPool& pool);
+
+inline void applyTransform(const ObjectBuffer& src, ObjectBuffer& dst, const ObjectTransform& transform) {
+	applyTransformSimd(src, dst, transform, 0, src.size());
+}
+
+// Per object pivot: every object is rotated / scaled about its own pivot (pivotX[i], pivotY[i]
+// in the same coords as the positions) and then moved by move:
+//   pos' = pivot + L * (pos - pivot) + move, where L is the linear part of the matrix.
+// Rotation and scale of the objects change the same way as in applyTransform()
+void applyPivotTransformScalar(const ObjectBuffer& src, const float* pivotX, const float* pivotY,
+								ObjectBuffer& dst, const ObjectTransform& transform, const Vec2 move,
+								const size_t begin, const size_t end);
+
+// same as applyPivotTransformScalar() but uses SSE2 / NEON when available
+void applyPivotTransformSimd(const ObjectBuffer& src, const float* pivotX, const float* pivotY,
+								ObjectBuffer& dst, const ObjectTransform& transform, const Vec2 move,
+								const size_t begin, const size_t end);
+
+// applyPivotTransformSimd() split across the threads of the pool
+void applyPivotTransformParallel(const ObjectBuffer& src, const float* pivotX, const float* pivotY,
+									ObjectBuffer& dst, const ObjectTransform& transform, const Vec2 move,
+									WorkerPool& pool);
+
+} // namespace itc
@@ -0,0 +1,52 @@
+#include "TransformQueue.hpp"
+
+namespace itc {
+
+void TransformQueue::push(const ObjectTransform& transform) {
+	m_transform = m_transform.then(transform);
+	m_count++;
+}
+
+void TransformQueue::move(const Vec2 delta) {
+	ObjectTransform t;
+	t.m_matrix = Affine::translation(delta);
+	push(t);
+}
+
+void TransformQueue::rotate(const float degrees, const Vec2 pivot) {
+	ObjectTransform t;
+	t.m_matrix = Affine::rotation(degrees).about(pivot);
+	t.m_rotX = degrees;
+	t.m_rotY = degrees;
+	push(t);
+}
+
+void TransformQueue::scale(const float factor, const Vec2 pivot) {
+	if (factor == 0) return;
+	ObjectTransform t;
+	t.m_matrix = Affine::scale(factor, factor).about(pivot);
+	t.m_scaleX = factor;
+	t.m_scaleY = factor;
+	push(t);
+}
+
+void TransformQueue::mirrorX(const Vec2 pivot) {
+	ObjectTransform t;
+	t.m_matrix = Affine::scale(-1, 1).about(pivot);
+	t.m_flipX = true;
+	push(t);
+}
+
+void TransformQueue::mirrorY(const Vec2 pivot) {
+	ObjectTransform t;
+	t.m_matrix = Affine::scale(1, -1).about(pivot);
+	t.m_flipY = true;
+	push(t);
+}
+
+void TransformQueue::clear() {
+	m_transform = {};
+	m_count = 0;
+}
+
+} // namespace itc
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include "Geometry.hpp"
+#include "TransformKernel.hpp"
+
+namespace itc {
+
+// Operations queued on the selection, composed into one ObjectTransform as they are added.
+// The selection is then transformed once (one pass over the objects, one undo entry)
+// instead of once per operation. Pivots are in object layer coords
+class TransformQueue {
+public:
+	void move(const Vec2 delta);
+	// clockwise, in degrees (same as the editor)
+	void rotate(const float degrees, const Vec2 pivot);
+	void scale(const float factor, const Vec2 pivot);
+	// mirror horizontally (around the vertical line through the pivot)
+	void mirrorX(const Vec2 pivot);
+	// mirror vertically (around the horizontal line through the pivot)
+	void mirrorY(const Vec2 pivot);
+
+	void clear();
+	bool empty() const { return m_count == 0; }
+	size_t size() const { return m_count; }
+
+	// all the queued operations (the first one is applied first)
+	const ObjectTransform& getTransform() const { return m_transform; }
+
+private:
+	void push(const ObjectTransform& transform);
+
+	ObjectTransform m_transform;
+	size_t m_count = 0;
+};
+
+} // namespace itc
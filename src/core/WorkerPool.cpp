@@ -0,0 +1,85 @@
+#include "WorkerPool.hpp"
+#include <algorithm>
+
+namespace itc {
+
+WorkerPool::WorkerPool(const unsigned workers) {
+	m_threads.reserve(workers);
+	for (unsigned i = 0; i < workers; i++) {
+		m_threads.emplace_back([this] { workerLoop(); });
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard lock(m_mutex);
+		m_stop = true;
+	}
+	m_wakeCv.notify_all();
+	for (auto& thread : m_threads) thread.join();
+}
+
+WorkerPool& WorkerPool::shared() {
+	static auto pool = new WorkerPool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+	return *pool;
+}
+
+void WorkerPool::parallelFor(const size_t count, const size_t alignment,
+								const ChunkFunc func) {
+	if (count == 0) return;
+	// a few chunks per thread, so that a slow thread doesn't keep everyone waiting
+	const size_t align = std::max<size_t>(1, alignment);
+	size_t chunk = count / (getThreadCount() * 4) + 1;
+	chunk = (chunk + align - 1) / align * align;
+	if (m_threads.empty() || chunk >= count) {
+		func(0, count);
+		return;
+	}
+	{
+		std::lock_guard lock(m_mutex);
+		m_func = &func;
+		m_count = count;
+		m_chunkSize = chunk;
+		m_chunkCount = (count + chunk - 1) / chunk;
+		m_nextChunk = 0;
+		m_doneChunks = 0;
+		m_generation++;
+	}
+	m_wakeCv.notify_all();
+	runChunks();
+	std::unique_lock lock(m_mutex);
+	// also wait for the workers to leave runChunks(), they mustn't see the next job's data
+	m_doneCv.wait(lock, [this] { return m_doneChunks == m_chunkCount && m_activeWorkers == 0; });
+	m_func = nullptr;
+}
+
+void WorkerPool::runChunks() {
+	size_t done = 0;
+	for (size_t i = m_nextChunk++; i < m_chunkCount; i = m_nextChunk++) {
+		const size_t begin = i * m_chunkSize;
+		(*m_func)(begin, std::min(begin + m_chunkSize, m_count));
+		done++;
+	}
+	if (done) m_doneChunks += done;
+}
+
+void WorkerPool::workerLoop() {
+	uint64_t seen = 0;
+	while (true) {
+		{
+			std::unique_lock lock(m_mutex);
+			m_wakeCv.wait(lock, [&] { return m_stop || (m_generation != seen && m_func); });
+			if (m_stop) return;
+			seen = m_generation;
+			m_activeWorkers++;
+		}
+		runChunks();
+		{
+			std::lock_guard lock(m_mutex);
+			m_activeWorkers--;
+		}
+		m_doneCv.notify_all();
+	}
+}
+
+} // namespace itc
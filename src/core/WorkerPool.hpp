@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace itc {
+
+// Non-owning reference to a func(begin, end) callable. Unlike std::function it never
+// allocates (lambdas with big captures would), the callable must outlive the call
+class ChunkFunc {
+public:
+	template <class F>
+	ChunkFunc(F& func)
+		: m_obj((void*)std::addressof(func)),
+		m_call([](void* obj, size_t begin, size_t end) { (*static_cast<F*>(obj))(begin, end); }) {}
+
+	void operator()(const size_t begin, const size_t end) const { m_call(m_obj, begin, end); }
+
+private:
+	void* m_obj;
+	void (*m_call)(void*, size_t, size_t);
+};
+
+// Fixed set of threads for splitting big loops across cores.
+// The calling thread works too and parallelFor() returns when every chunk is done.
+class WorkerPool {
+public:
+	// workers = number of extra threads (0 - everything runs on the calling thread)
+	explicit WorkerPool(const unsigned workers);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	// pool with a thread per core. It's never destroyed on purpose: joining threads while
+	// the mod library is unloaded (DllMain on windows) can deadlock
+	static WorkerPool& shared();
+
+	// number of threads that do the work (including the calling one)
+	unsigned getThreadCount() const { return (unsigned)m_threads.size() + 1; }
+
+	// run func(begin, end) for chunks of [0, count). Chunk boundaries are multiples of
+	// alignment, so e.g. a SIMD kernel processes every element the same way no matter
+	// how many threads there are. Must not be called from the workers
+	void parallelFor(const size_t count, const size_t alignment, const ChunkFunc func);
+
+	template <class F>
+	void parallelFor(const size_t count, const size_t alignment, F&& func) {
+		parallelFor(count, alignment, ChunkFunc(func));
+	}
+
+private:
+	void workerLoop();
+	void runChunks();
+
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_wakeCv;
+	std::condition_variable m_doneCv;
+	bool m_stop = false;
+	uint64_t m_generation = 0; // incremented for every job
+	unsigned m_activeWorkers = 0; // workers inside runChunks()
+
+	// current job
+	const ChunkFunc* m_func = nullptr;
+	size_t m_count = 0;
+	size_t m_chunkSize = 0;
+	size_t m_chunkCount = 0;
+	std::atomic<size_t> m_nextChunk{0};
+	std::atomic<size_t> m_doneChunks{0};
+};
+
+} // namespace itc
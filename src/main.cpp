@@ -1,38 +1,242 @@
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <optional>
+#include <unordered_map>
 #include <Geode/Geode.hpp>
 #include <Geode/modify/GJTransformControl.hpp>
 #include <Geode/modify/EditorUI.hpp>
+#include <Geode/modify/GJBaseGameLayer.hpp>
+#include <Geode/modify/LevelEditorLayer.hpp>
+#include "core/Affine.hpp"
+#include "core/AllocCounter.hpp"
+#include "core/AngleHistogram.hpp"
+#include "core/ControlLogic.hpp"
+#include "core/Geometry.hpp"
+#include "core/GestureRecording.hpp"
+#include "core/LruCache.hpp"
+#include "core/OrientedBounds.hpp"
+#include "core/Profiler.hpp"
+#include "core/ScratchArena.hpp"
+#include "core/SelectionBounds.hpp"
+#include "core/SelectionKey.hpp"
+#include "core/SnapLines.hpp"
+#include "core/SpatialGrid.hpp"
+#include "core/TransformHistory.hpp"
+#include "core/TransformQueue.hpp"
+#include "core/TransformFrame.hpp"
+#include "core/WorkerPool.hpp"
+#include "GroupTransformPopup.hpp"
+#include "GuideOverlay.hpp"
+#include "LineBatch.hpp"
+#include "ObjectBatch.hpp"
+#include "SectionBatch.hpp"
+#include "SelectionOutlines.hpp"
+#include "SelectionProxy.hpp"
+#include "TransformArgs.hpp"
 using namespace geode::prelude;
 
 #define SNAP_COL ccc3(255, 135, 0)
 #define LOCK_COL ccc3(155, 155, 155)
 #define WHITE_COL ccc3(255, 255, 255)
 
-// max error in fp measurements (in points)
-#define MAX_FP_ERROR 0.01f
+using itc::MAX_FP_ERROR;
+
+// max distance from a guide at which the "Guide" button removes it (in level units)
+constexpr float GUIDE_TOGGLE_DIST = 1;
+// first tag of the compact undo markers (the editor's own undo objects aren't tagged)
+constexpr int UNDO_MARKER_TAG = 0x17C00000;
 
 struct MyGJTransformControl;
 
+// apply the pending transform of the selection proxy (see MyEditorUI)
+void commitSelectionProxy();
+// the controls loaded the values of the objects again (see MyEditorUI)
+void resetAppliedArgs();
+// start / end of a transform gesture (see MyEditorUI)
+void beginTransformGesture();
+void endTransformGesture();
+// add the guides through the point (object layer coords), or remove the ones it's on (see MyEditorUI)
+void toggleGuides(const CCPoint& levelPos);
+// transform every object of the group (see MyEditorUI)
+void transformGroup(const GroupTransform& transform);
+// deactivate and activate the controls right away (see MyEditorUI)
+void reopenTransformControl();
+// show the guides only while the "snap-guides" setting is on (see MyEditorUI)
+void updateGuideOverlay();
+
+inline itc::Vec2 toVec2(const CCPoint& p) { return {p.x, p.y}; }
+inline CCPoint toCCPoint(const itc::Vec2& v) { return ccp(v.x, v.y); }
+
+inline itc::Rect getObjectBounds(GameObject* obj) {
+	const auto rect = obj->getObjectRect();
+	return {{rect.getMinX(), rect.getMinY()}, {rect.getMaxX(), rect.getMaxY()}};
+}
+
 struct {
 	bool m_isSnap = false;
 	bool m_isFreeRot = false;
 	bool m_isRotDirty = false;
+	bool m_isObjectPivot = false; // every object is rotated / scaled about its own pivot
+	bool m_isInTouchMove = false; // is the transform controls ccTouchMoved on the call stack
+	bool m_isInGesture = false; // between ccTouchBegan and ccTouchEnded of the transform controls
+	// undo object the editor created for the current gesture (see compact undo in MyEditorUI)
+	Ref<UndoObject> m_gestureUndo;
+	bool m_gestureUndoArg = false;
 	float m_freeRotFinalAngle = 0;
 	MyGJTransformControl* m_transformControls = nullptr;
+	// snap points of the level objects. It's built the first time the anchor 
+	// snaps to objects and then updated by the hooks when objects are changed
+	itc::SpatialGrid m_objectGrid;
+	bool m_isObjectGridReady = false;
+	// rotations of the level objects (for the rotation snap), kept the same way as the grid
+	itc::AngleHistogram m_angleHistogram;
+	bool m_isAngleHistogramReady = false;
+	// level objects by id (for compact undo). Built the first time an id is looked up, then
+	// kept by the create / remove hooks. Objects the hooks didn't see rebuild it
+	std::unordered_map<int, Ref<GameObject>> m_objectsById;
+	bool m_isObjectMapReady = false;
+	// selected objects (id -> its part of m_selectionKey), kept by the select / deselect hooks
+	// (anchor doesn't snap to the selected objects)
+	std::unordered_map<int, uint64_t> m_selection;
+	// hash of the selected objects and their transforms (see MyEditorUI::m_stateCache)
+	itc::SelectionKey m_selectionKey;
+	// bounds of the selected objects, kept the same way (see MyEditorUI::getGroupCenter())
+	itc::SelectionBounds m_selectionBounds;
+	// selected objects were changed, the parts of the key and the bounds are outdated
+	bool m_isSelectionMoved = false;
+	// guides placed with the "Guide" button of the controls (object layer coords)
+	itc::GuideLines m_guides;
 	// mod settings
 	struct {
 		ccColor4B m_interfaceCol;
 		bool m_centerSnap; // if anchor also snaps to the center
+		bool m_objectSnap; // if anchor also snaps to other objects
 		int m_showInterface; // 1 - never, 2 - always, 3 - on change
+		bool m_proxyPreview; // transform only the outlines during the drag
+		int m_proxyThreshold; // min number of objects for the proxy preview
+		bool m_fastTransform; // transform big selections with ObjectBatch
+		bool m_compactUndo; // record transform gestures in TransformHistory
+		int m_fastTransformThreshold; // min number of objects for the fast transform
+		bool m_recordGestures; // save every gesture for the replay harness (see replay/)
+		bool m_coalesceMoves; // apply only the last touch move of every frame
+		bool m_centerAnchor; // put the anchor in the center of the rect on activation
+		bool m_cacheControlState; // restore the controls of recently used selections
+		bool m_cacheSelectionBounds; // the center of the selection comes from m_selectionBounds
+		bool m_batchSections; // reorder the sections of the objects once per transform
+		bool m_angleSnap; // rotation also snaps to the common angles of the level
+		bool m_showOutlines; // outline every selected object during the transform
+		bool m_deferControlUpdates; // rebuild the controls at most once per frame
+		int m_objectPivot; // own pivot of the objects (see ObjectBatch::Pivot)
+		int m_gridSnap; // 1 - off, 2 - blocks, 3 - half blocks...
+		bool m_guideSnap; // snap to the guides (and show the "Guide" button)
+		bool m_groupTransform; // show the "Group" button
 		void update() {
 			m_interfaceCol = Mod::get()->getSettingValue<cocos2d::ccColor4B>("interface-color");
 			m_centerSnap = Mod::get()->getSettingValue<bool>("snap-center");
+			m_objectSnap = Mod::get()->getSettingValue<bool>("snap-objects");
 			m_showInterface = std::atoi(Mod::get()->getSettingValue<std::string>("show-interface").c_str());
 			if (m_showInterface < 1 || m_showInterface > 3) m_showInterface = 1;
+			m_proxyPreview = Mod::get()->getSettingValue<bool>("proxy-preview");
+			m_proxyThreshold = (int)Mod::get()->getSettingValue<int64_t>("proxy-threshold");
+			m_fastTransform = Mod::get()->getSettingValue<bool>("fast-transform");
+			m_compactUndo = Mod::get()->getSettingValue<bool>("compact-undo");
+			m_fastTransformThreshold = (int)Mod::get()->getSettingValue<int64_t>("fast-transform-threshold");
+			m_recordGestures = Mod::get()->getSettingValue<bool>("record-gestures");
+			m_coalesceMoves = Mod::get()->getSettingValue<bool>("coalesce-moves");
+			m_centerAnchor = Mod::get()->getSettingValue<bool>("center-anchor");
+			m_cacheControlState = Mod::get()->getSettingValue<bool>("cache-control-state");
+			m_cacheSelectionBounds = Mod::get()->getSettingValue<bool>("cache-selection-bounds");
+			m_batchSections = Mod::get()->getSettingValue<bool>("batch-sections");
+			m_angleSnap = Mod::get()->getSettingValue<bool>("snap-common-angles");
+			m_showOutlines = Mod::get()->getSettingValue<bool>("show-outlines");
+			m_deferControlUpdates = Mod::get()->getSettingValue<bool>("defer-control-updates");
+			m_objectPivot = std::atoi(Mod::get()->getSettingValue<std::string>("object-pivot").c_str());
+			if (m_objectPivot < 1 || m_objectPivot > 5) m_objectPivot = 1;
+			m_gridSnap = std::atoi(Mod::get()->getSettingValue<std::string>("snap-grid").c_str());
+			if (m_gridSnap < 1 || m_gridSnap > 5) m_gridSnap = 1;
+			m_guideSnap = Mod::get()->getSettingValue<bool>("snap-guides");
+			m_groupTransform = Mod::get()->getSettingValue<bool>("group-transform");
 		}
 	} m_settings;
 } GLOBAL;
 
+// number of selected objects (for the profiler)
+inline size_t getSelectionSize() {
+	auto editor = EditorUI::get();
+	if (!editor) return 0;
+	if (editor->m_selectedObject) return 1;
+	return editor->m_selectedObjects ? editor->m_selectedObjects->count() : 0;
+}
+
+inline void updateObjectAngle(GameObject* obj) {
+	// skewed objects don't have one angle
+	if (obj->getRotationX() != obj->getRotationY()) {
+		GLOBAL.m_angleHistogram.remove(obj->m_uniqueID);
+	} else {
+		GLOBAL.m_angleHistogram.update(obj->m_uniqueID, obj->getRotationX());
+	}
+}
+
+// is the object snap grid or the angle histogram built
+inline bool isTrackingObjects() {
+	return GLOBAL.m_isObjectGridReady || GLOBAL.m_isAngleHistogramReady;
+}
+
+// keep the object snap grid and the angle histogram up to date (nothing to do if they're not built yet)
+inline void updateObjectSnapPoints(GameObject* obj) {
+	if (GLOBAL.m_isObjectGridReady) GLOBAL.m_objectGrid.update(obj->m_uniqueID, getObjectBounds(obj));
+	if (GLOBAL.m_isAngleHistogramReady) updateObjectAngle(obj);
+}
+
+inline void updateObjectSnapPoints(CCArray* objs) {
+	if (!objs || !isTrackingObjects()) return;
+	for (auto obj : CCArrayExt<GameObject*>(objs)) {
+		updateObjectSnapPoints(obj);
+	}
+}
+
+inline void removeObjectSnapPoints(GameObject* obj) {
+	if (GLOBAL.m_isObjectGridReady) GLOBAL.m_objectGrid.remove(obj->m_uniqueID);
+	if (GLOBAL.m_isAngleHistogramReady) GLOBAL.m_angleHistogram.remove(obj->m_uniqueID);
+}
+
+inline void addToSelection(GameObject* obj) {
+	const auto pos = obj->getPosition();
+	const uint64_t part = itc::SelectionKey::hashObject(obj->m_uniqueID, pos.x, pos.y,
+		obj->getRotationX(), obj->getRotationY(), obj->m_scaleX, obj->m_scaleY);
+	const auto [it, inserted] = GLOBAL.m_selection.try_emplace(obj->m_uniqueID, part);
+	if (!inserted) {
+		GLOBAL.m_selectionKey.remove(it->second);
+		it->second = part;
+	}
+	GLOBAL.m_selectionKey.add(part);
+	GLOBAL.m_selectionBounds.add(obj->m_uniqueID, getObjectBounds(obj), toVec2(obj->getPosition()));
+}
+
+inline void removeFromSelection(int id) {
+	const auto it = GLOBAL.m_selection.find(id);
+	if (it == GLOBAL.m_selection.end()) return;
+	GLOBAL.m_selectionKey.remove(it->second);
+	GLOBAL.m_selection.erase(it);
+	GLOBAL.m_selectionBounds.remove(id);
+}
+
+inline void clearSelection() {
+	GLOBAL.m_selection.clear();
+	GLOBAL.m_selectionKey.clear();
+	GLOBAL.m_selectionBounds.clear();
+	GLOBAL.m_isSelectionMoved = false;
+}
+
+// grid and guide lines the anchor and the handles snap to (in object layer coords)
+inline itc::SnapLines getSnapLines() {
+	itc::SnapLines lines;
+	if (GLOBAL.m_settings.m_gridSnap > 1) lines.m_gridStep = itc::getGridStep(GLOBAL.m_settings.m_gridSnap - 2);
+	if (GLOBAL.m_settings.m_guideSnap) lines.m_guides = &GLOBAL.m_guides;
+	return lines;
+}
+
 /*
 Transform controls scheme: (each sprite has a unique index)
 
@@ -50,11 +254,16 @@ Transform controls scheme: (each sprite has a unique index)
 
 class GJTransformControlInterface : public CCNode {
 private:
-	GJTransformControl* m_transformControl;
+	MyGJTransformControl* m_transformControl;
 	bool m_visibleRect = false;
 	bool m_visibleRot = false;
+	// the interface geometry is kept between frames and rebuilt only when it's dirty
+	LineBatch m_batch;
+	std::vector<std::pair<CCPoint, CCPoint>> m_overlayLines; // extra lines (m_mainNode coords)
+	bool m_dirty = true;
+	uint32_t m_frameVersion = 0; // version of the transform frame the batch was built from
 public:
-	static GJTransformControlInterface* create(GJTransformControl* transformControl) {
+	static GJTransformControlInterface* create(MyGJTransformControl* transformControl) {
 		auto ret = new GJTransformControlInterface();
 		if (ret && ret->init(transformControl)) {
 			ret->autorelease();
@@ -64,38 +273,55 @@ public:
 		return nullptr;
 	}
 
-	bool init(GJTransformControl* transformControl) {
+	bool init(MyGJTransformControl* transformControl) {
 		m_transformControl = transformControl;
 		this->setID("razoom.improved-transform-control.interface");
 		return true;
 	}
 
 	void setInterfaceVisibility(bool rect, bool rot) {
+		if (m_visibleRect != rect || m_visibleRot != rot) m_dirty = true;
 		m_visibleRect = rect;
 		m_visibleRot = rot;
 	}
 
-	void draw() override {
-		ccDrawColor4B(GLOBAL.m_settings.m_interfaceCol);
-		if (m_visibleRect) {
-			auto tl = m_transformControl->spriteByTag(6);
-			auto br = m_transformControl->spriteByTag(9);
-			auto t = m_transformControl->spriteByTag(4);
-			auto b = m_transformControl->spriteByTag(5);
-			auto l = m_transformControl->spriteByTag(2);
-			auto r = m_transformControl->spriteByTag(3);
-			ccDrawRect(tl->getPosition(), br->getPosition());
+	void setDirty() {
+		m_dirty = true;
+	}
 
-			ccDrawLine(t->getPosition(),b->getPosition());
-			ccDrawLine(l->getPosition(), r->getPosition());
-		}
-		// if (m_visibleRot) {
-		// 	auto rotPos = m_transformControl->m_rotatePosition;
-		// 	ccDrawLine(ccp(0,0), rotPos);
-		// }
+	void addOverlayLine(const CCPoint& a, const CCPoint& b) {
+		m_overlayLines.emplace_back(a, b);
+		m_dirty = true;
+	}
+
+	void clearOverlay() {
+		if (m_overlayLines.empty()) return;
+		m_overlayLines.clear();
+		m_dirty = true;
 	}
+
+	void rebuild(const itc::TransformFrame& frame);
+
+	void draw() override;
 };
 
+// state of the controls that isn't loaded from the objects (see MyEditorUI::m_stateCache)
+struct ControlState {
+	float m_rotation = 0;
+	itc::Vec2 m_anchor; // in m_mainNode parent coords
+	uint16_t m_disabledSpritesSnap = 0;
+	uint16_t m_disabledSpritesRot = 0;
+	float m_lockedRotation = 0;
+	bool m_isFreeRot = false;
+};
+
+// sprites of a toggle button, created once and swapped when it's toggled
+struct ToggleSprites {
+	Ref<CCSprite> m_off;
+	Ref<CCSprite> m_on;
+
+	CCSprite* get(bool isOn) const { return isOn ? m_on.data() : m_off.data(); }
+};
 
 class $modify(MyGJTransformControl, GJTransformControl) {
 	struct Fields {
@@ -103,9 +329,36 @@ class $modify(MyGJTransformControl, GJTransformControl) {
 		CCMenu* m_menu;
 		CCMenuItemSpriteExtra* m_rotBtn;
 		CCMenuItemSpriteExtra* m_snapBtn;
+		CCMenuItemSpriteExtra* m_fitBtn;
+		CCMenuItemSpriteExtra* m_pivotBtn;
+		CCMenuItemSpriteExtra* m_guideBtn;
+		CCMenuItemSpriteExtra* m_groupBtn;
+		ToggleSprites m_snapSprites;
+		ToggleSprites m_rotSprites;
+		ToggleSprites m_pivotSprites;
 		uint16_t m_disabledSpritesRot = 0;  // sprites disabled because of free rotation or snap
 		uint16_t m_disabledSpritesSnap = 0; // both are bit arrays (lowest 12 bits used - one for each sprite)
 		Ref<GJTransformControlInterface> m_interface;
+		CCLabelBMFont* m_profilerLabel = nullptr; // profiler overlay
+		CCSprite* m_sprites[itc::SPRITE_COUNT + 1] = {}; // spriteByTag() results (index is the tag)
+		// free rotation (see loadValues())
+		Ref<GameObject> m_rotationObj;
+		bool m_isRotationInjected = false;
+		itc::TransformFrame m_frame; // cached rect of the controls (see getFrame())
+		// gesture recording (see core/GestureRecording.hpp)
+		bool m_isRecording = false;
+		itc::GestureRecording m_recording;
+		itc::GestureEvent m_event; // event being recorded
+		double m_recordingStart = 0;
+		// coalesced touch moves (see ccTouchMoved())
+		Ref<CCTouch> m_pendingTouch;
+		bool m_hasPendingMove = false;
+		CCPoint m_pendingPrevView; // previous location of the first buffered move
+		// touch RobTop's code gets while a scale handle snaps to the lines (see snapHandleTouch())
+		Ref<CCTouch> m_snapTouch;
+		// heap allocations of the touch moves (only with ITC_ALLOC_COUNTER, see countMoveAllocations())
+		uint32_t m_gestureMoves = 0;
+		uint64_t m_steadyAllocations = 0;
 
 		~Fields() {GLOBAL.m_transformControls = nullptr;}
 	};
@@ -114,53 +367,132 @@ class $modify(MyGJTransformControl, GJTransformControl) {
 		return m_fields->m_disabledSpritesSnap | m_fields->m_disabledSpritesRot;
 	}
 
+	// cached spriteByTag()
+	inline CCSprite* sprite(int tag) {
+		return m_fields->m_sprites[tag];
+	}
+
+	// the frame is rebuilt only if it was invalidated or the rotation has changed
+	const itc::TransformFrame& getFrame() {
+		auto& frame = m_fields->m_frame;
+		const float rotation = m_mainNode->getRotation();
+		if (!frame.isValidFor(rotation)) {
+			frame.rebuild(getHandlePositions(), rotation);
+		}
+		return frame;
+	}
+
+	inline void invalidateFrame() {
+		m_fields->m_frame.invalidate();
+		if (m_fields->m_interface) m_fields->m_interface->setDirty();
+	}
+
 	$override 
 	bool init() {
 		if (!GJTransformControl::init()) return false;
 		GLOBAL.m_transformControls = this;
 
+		for (int i = 1; i <= itc::SPRITE_COUNT; i++) {
+			m_fields->m_sprites[i] = spriteByTag(i);
+		}
+
+		// created once and reused for every activation with free rotation
+		m_fields->m_rotationObj = GameObject::createWithKey(929);
+		m_fields->m_rotationObj->commonSetup();
+		m_fields->m_rotationObj->m_outerSectionIndex = -1;
+
 		// fix menu sprite 10 and button overlapping 
 		m_fields->m_menu = static_cast<CCMenu*>(this->m_warpLockButton->getParent());
 		m_fields->m_menu->setAnchorPoint(ccp(0,0));
 		m_warpLockButton->setPosition(ccp(-30, 20));
 
+		// toggle sprites are swapped, not recreated
+		m_fields->m_snapSprites = {CCSprite::createWithSpriteFrameName("snapOffBtn_001.png"_spr),
+			CCSprite::createWithSpriteFrameName("snapOnBtn_001.png"_spr)};
+		m_fields->m_rotSprites = {CCSprite::createWithSpriteFrameName("freeRotOffBtn_001.png"_spr),
+			CCSprite::createWithSpriteFrameName("freeRotOnBtn_001.png"_spr)};
+		m_fields->m_pivotSprites = {createPivotBtnSprite(false), createPivotBtnSprite(true)};
+
 		// add new buttons to the menu
 		m_fields->m_snapBtn = CCMenuItemSpriteExtra::create(
-			CCSprite::createWithSpriteFrameName("snapOffBtn_001.png"_spr), 
+			m_fields->m_snapSprites.get(false), 
 			this, menu_selector(MyGJTransformControl::onSnapBtn));
 		m_fields->m_rotBtn = CCMenuItemSpriteExtra::create(
-			CCSprite::createWithSpriteFrameName("freeRotOffBtn_001.png"_spr), 
+			m_fields->m_rotSprites.get(false), 
 			this, menu_selector(MyGJTransformControl::onRotBtn));
 		
+		auto fitSpr = ButtonSprite::create("Fit", "bigFont.fnt", "GJ_button_04.png", .6f);
+		fitSpr->setScale(.5f);
+		m_fields->m_fitBtn = CCMenuItemSpriteExtra::create(
+			fitSpr, this, menu_selector(MyGJTransformControl::onFitBtn));
+		m_fields->m_pivotBtn = CCMenuItemSpriteExtra::create(
+			m_fields->m_pivotSprites.get(false), this, menu_selector(MyGJTransformControl::onPivotBtn));
+		auto guideSpr = ButtonSprite::create("Guide", "bigFont.fnt", "GJ_button_04.png", .6f);
+		guideSpr->setScale(.5f);
+		m_fields->m_guideBtn = CCMenuItemSpriteExtra::create(
+			guideSpr, this, menu_selector(MyGJTransformControl::onGuideBtn));
+		auto groupSpr = ButtonSprite::create("Group", "bigFont.fnt", "GJ_button_04.png", .6f);
+		groupSpr->setScale(.5f);
+		m_fields->m_groupBtn = CCMenuItemSpriteExtra::create(
+			groupSpr, this, menu_selector(MyGJTransformControl::onGroupBtn));
+		
 		m_fields->m_menu->addChild(m_fields->m_snapBtn);
 		m_fields->m_menu->addChild(m_fields->m_rotBtn);
+		m_fields->m_menu->addChild(m_fields->m_fitBtn);
+		m_fields->m_menu->addChild(m_fields->m_pivotBtn);
+		m_fields->m_menu->addChild(m_fields->m_guideBtn);
+		m_fields->m_menu->addChild(m_fields->m_groupBtn);
 
 		m_fields->m_snapBtn->setPosition(ccp(0, 20));
 		m_fields->m_rotBtn->setPosition(ccp(30, 20));
+		m_fields->m_fitBtn->setPosition(ccp(60, 20));
+		m_fields->m_pivotBtn->setPosition(ccp(90, 20));
+		m_fields->m_guideBtn->setPosition(ccp(120, 20));
+		m_fields->m_groupBtn->setPosition(ccp(150, 20));
 		
 		// add labels to the buttons
 		auto labelSnap = CCLabelBMFont::create("Snap", "bigFont.fnt");
 		auto labelPos = CCLabelBMFont::create("ScaleXY", "bigFont.fnt");
 		auto labelRot = CCLabelBMFont::create("FreeRot", "bigFont.fnt");
+		auto labelFit = CCLabelBMFont::create("AutoFit", "bigFont.fnt");
+		auto labelPivot = CCLabelBMFont::create("EachObj", "bigFont.fnt");
+		auto labelGuide = CCLabelBMFont::create("Guides", "bigFont.fnt");
+		auto labelGroup = CCLabelBMFont::create("GroupID", "bigFont.fnt");
 
 		m_fields->m_snapBtn->addChildAtPosition(labelSnap, Anchor::Bottom);
 		m_fields->m_rotBtn->addChildAtPosition(labelRot, Anchor::Bottom);
+		m_fields->m_fitBtn->addChildAtPosition(labelFit, Anchor::Bottom);
+		m_fields->m_pivotBtn->addChildAtPosition(labelPivot, Anchor::Bottom);
+		m_fields->m_guideBtn->addChildAtPosition(labelGuide, Anchor::Bottom);
+		m_fields->m_groupBtn->addChildAtPosition(labelGroup, Anchor::Bottom);
 		m_warpLockButton->addChildAtPosition(labelPos, Anchor::Bottom);
 
 		labelSnap->setScale(.2f);
 		labelRot->setScale(.2f);
+		labelFit->setScale(.2f);
+		labelPivot->setScale(.2f);
+		labelGuide->setScale(.2f);
+		labelGroup->setScale(.2f);
 		labelPos->setScale(.2f);
 
 		// reset global state
 		GLOBAL.m_isFreeRot = false;
 		GLOBAL.m_isRotDirty = false;
 		GLOBAL.m_isSnap = false;
+		GLOBAL.m_isObjectPivot = false;
 
 		// add interface node
 		m_fields->m_interface = GJTransformControlInterface::create(this);
 		if (m_fields->m_interface == nullptr) return false;
 		m_mainNode->addChild(m_fields->m_interface);
 
+		// profiler overlay
+		m_fields->m_profilerLabel = CCLabelBMFont::create("", "chatFont.fnt");
+		m_fields->m_profilerLabel->setAnchorPoint(ccp(0, 1));
+		m_fields->m_profilerLabel->setScale(.5f);
+		this->addChild(m_fields->m_profilerLabel);
+		updateProfilerSchedule();
+
 		// show interface: 1 - never, 2 - always, 3 - on change
 		if (GLOBAL.m_settings.m_showInterface == 2)
 			m_fields->m_interface->setInterfaceVisibility(true, true);
@@ -171,42 +503,32 @@ class $modify(MyGJTransformControl, GJTransformControl) {
 
 	// I call this before EditorUI::activateTransformControls()
 	void prepareToActivate() {
+		invalidateFrame();
+		updateGuideBtn();
+		m_fields->m_groupBtn->setVisible(GLOBAL.m_settings.m_groupTransform);
 		m_fields->m_disabledSpritesSnap = 0;
 		m_fields->m_disabledSpritesRot = 0;
 		if (GLOBAL.m_isFreeRot) {
-			m_fields->m_rotBtn->setSprite(
-				CCSprite::createWithSpriteFrameName("freeRotOffBtn_001.png"_spr));
+			m_fields->m_rotBtn->setSprite(m_fields->m_rotSprites.get(false));
 			GLOBAL.m_isFreeRot = false;
 		}
 	}
 
 	void updateDisabledSprites() {
-		uint16_t mask = 0b100000000000;
 		const uint16_t disabled = getDisabledSprites();
-		for(int i = 1; i < 13; i++) {
-			auto spr = spriteByTag(i);
+		for (int i = 1; i <= itc::SPRITE_COUNT; i++) {
 			// check if the sprite is disabled
-			spr->setColor((mask & disabled) ? LOCK_COL : WHITE_COL);
-			mask = mask >> 1;
+			sprite(i)->setColor((itc::spriteBit(i) & disabled) ? LOCK_COL : WHITE_COL);
 		}
 	}
 
 	void setDisabledSpritesByNodeIndex(short indx) {
-		switch (indx) {
-			case 2: m_fields->m_disabledSpritesSnap = 0b010001010000; break; // 2,6,8
-			case 3: m_fields->m_disabledSpritesSnap = 0b001000101000; break; // 3,7,9
-			case 4: m_fields->m_disabledSpritesSnap = 0b000101100000; break; // 4,6,7
-			case 5: m_fields->m_disabledSpritesSnap = 0b000010011000; break; // 5,8,9
-			case 6: m_fields->m_disabledSpritesSnap = 0b010101110000; break; // 2,4,6,7,8
-			case 7: m_fields->m_disabledSpritesSnap = 0b001101101000; break; // 3,4,6,7,9
-			case 8: m_fields->m_disabledSpritesSnap = 0b010011011000; break; // 2,5,6,8,9
-			case 9: m_fields->m_disabledSpritesSnap = 0b001010111000; break; // 3,5,7,8,9
-			default: m_fields->m_disabledSpritesSnap = 0; break;
-		}
+		m_fields->m_disabledSpritesSnap = itc::getDisabledSpritesForNode((uint8_t)indx);
 	}
 
 	void checkAndUpdateDisabledSpritesForCurrentAnchorPosition() {
-		const auto anchor = spriteByTag(1);
+		invalidateFrame();
+		const auto anchor = sprite(1);
 		auto aPos = anchor->getPosition();
 		uint8_t snapNodeIndx = 0;
 
@@ -217,106 +539,434 @@ class $modify(MyGJTransformControl, GJTransformControl) {
 		updateDisabledSprites();
 	}
 
+	itc::HandlePositions getHandlePositions() {
+		itc::HandlePositions handles;
+		for (int i = 2; i < 10; i++) {
+			handles.m_pos[i] = toVec2(sprite(i)->getPosition());
+		}
+		return handles;
+	}
+
 	// return true and set snapCoords and snapSpriteIndex if anchor snaps
 	bool checkAnchorSnaps(const float limit, const CCPoint anchor, CCPoint* const snapCoords, 
 							uint8_t* const spriteIndex, bool checkCenter) {
-		// math code alert! - convert anchor pos to mainNode coords
-		const double sin = std::sin(m_mainNode->getRotation()*M_PI/180.0);
-		const double cos = std::cos(m_mainNode->getRotation()*M_PI/180.0);
-		const auto anchorRelPos = ccp(
-			cos * anchor.x - sin * anchor.y, sin * anchor.x + cos * anchor.y);
-		// check distance between the anchor and other sprites
-		for (int i = 1; i < 10; i++) {
-			CCPoint nodePos;
-			if (i != 1) {
-				nodePos = spriteByTag(i)->getPosition();
-			} else {
-				if (!checkCenter) continue;
-				// get center
-				nodePos = (spriteByTag(7)->getPosition() + spriteByTag(8)->getPosition()) / 2.0;
-			}
-			CCPoint distVec = anchorRelPos - nodePos;
-			auto distSq = distVec.x * distVec.x + distVec.y * distVec.y;
-			if (distSq < limit * limit) {
-				*snapCoords = ccp(
-					cos * nodePos.x + sin * nodePos.y, -sin * nodePos.x + cos * nodePos.y);
-				*spriteIndex = i;
-				return true;
-			}
+		itc::Vec2 snap;
+		if (!getFrame().checkAnchorSnaps(limit, toVec2(anchor), &snap, spriteIndex, checkCenter)) {
+			return false;
 		}
-		return false;
+		*snapCoords = toCCPoint(snap);
+		return true;
 	}
 
 	// check if the anchor is aligned with the edges of rectangle or their extensions. 
 	// returns the result and sets the spriteIndex
 	bool checkAnchorIsOnEdge(const float limit, const CCPoint anchor, uint8_t* const spriteIndex) {
-		// math code alert! - convert anchor pos to mainNode coords
-		const double sin = std::sin(m_mainNode->getRotation()*M_PI/180.0);
-		const double cos = std::cos(m_mainNode->getRotation()*M_PI/180.0);
-		const auto anchorRelPos = ccp(
-			cos * anchor.x - sin * anchor.y, sin * anchor.x + cos * anchor.y);
-		// vertices cw
-		CCPoint v[] = {spriteByTag(6)->getPosition(), spriteByTag(7)->getPosition(), 
-						spriteByTag(9)->getPosition(), spriteByTag(8)->getPosition()};
-		uint8_t alignedEdges = 0;
-		// check all rect edges
-		for (int A = 3, B = 0; B < 4; A = B++) {
-			float ABx = v[B].x - v[A].x;
-			float ABy = v[B].y - v[A].y;
-			auto C = anchorRelPos;
-			if (std::abs(ABx) > std::abs(ABy)) {
-				float ACx = C.x - v[A].x;
-				float ACy = C.y - v[A].y;
-				float tg = ABy / ABx;
-				float y = tg * ACx;
-				if (std::abs(ACy - y) < limit) {
-					alignedEdges |= 0b1000 >> B;
-				}
-			} else {
-				float BCx = v[B].x - C.x;
-				float BCy = v[B].y - C.y;
-				float tg = ABx / ABy;
-				float x = tg * BCy;
-				if (std::abs(BCx - x) < limit) {
-					alignedEdges |= 0b1000 >> B;
-				}
+		return getFrame().checkAnchorIsOnEdge(limit, toVec2(anchor), spriteIndex);
+	}
+
+	// (re)build the grid of object snap points if it's not up to date
+	static void ensureObjectGrid() {
+		if (GLOBAL.m_isObjectGridReady) return;
+		auto& grid = GLOBAL.m_objectGrid;
+		grid.clear();
+		if (auto level = LevelEditorLayer::get()) {
+			for (auto obj : CCArrayExt<GameObject*>(level->m_objects)) {
+				grid.update(obj->m_uniqueID, getObjectBounds(obj));
 			}
 		}
-		switch (alignedEdges) {
-			case 0b1000: *spriteIndex = 2; break;
-			case 0b0100: *spriteIndex = 4; break;
-			case 0b0010: *spriteIndex = 3; break;
-			case 0b0001: *spriteIndex = 5; break;
-			case 0b1100: *spriteIndex = 6; break;
-			case 0b0110: *spriteIndex = 7; break;
-			case 0b0011: *spriteIndex = 9; break;
-			case 0b1001: *spriteIndex = 8; break;
-			default: return false;
+		GLOBAL.m_isObjectGridReady = true;
+	}
+
+	// return true and set snapCoords if anchor snaps to a corner or the center of 
+	// some object (except the selected ones)
+	bool checkAnchorSnapsToObjects(const float limit, const CCPoint anchor, CCPoint* const snapCoords) {
+		if (!LevelEditorLayer::get()) return false;
+		ensureObjectGrid();
+		const auto& selected = GLOBAL.m_selection;
+		itc::Vec2 snap;
+		int snapId;
+		if (!GLOBAL.m_objectGrid.queryNearest(toVec2(toLevel(anchor)), toLevelDistance(limit), 
+				[&](int id) { return selected.contains(id); }, &snap, &snapId)) {
+			return false;
 		}
+		*snapCoords = fromLevel(toCCPoint(snap));
+		return true;
+	}
+
+	// return true and set snapCoords if the anchor snaps to the grid or a guide
+	// (every axis snaps on its own, see core/SnapLines.hpp)
+	bool checkAnchorSnapsToLines(const float limit, const CCPoint anchor, CCPoint* const snapCoords) {
+		const auto lines = getSnapLines();
+		if (lines.empty() || !LevelEditorLayer::get()) return false;
+		itc::Vec2 snap;
+		if (!lines.snapPoint(toVec2(toLevel(anchor)), toLevelDistance(limit), &snap)) return false;
+		*snapCoords = fromLevel(toCCPoint(snap));
 		return true;
 	}
+
+	// Scale handles snap to the grid and the guides before RobTop's code: the touch it gets
+	// is moved to the closest crossing of the handle's axis (in the rotated frame) with a
+	// snap line. RobTop only uses the projection of the touch on the axis, so the handle
+	// lands on the line. A corner only lands where the touch is on both axes of the frame
+	// at once (with the ScaleXY lock it can't leave its diagonal anyway), so it snaps on its
+	// diagonal through the anchor, while the touch is close to it
+	CCTouch* snapHandleTouch(CCTouch* touch, uint8_t* const flags) {
+		const auto snapTouch = m_fields->m_snapTouch.data();
+		const auto level = LevelEditorLayer::get();
+		const int button = m_transformButtonType;
+		const uint8_t edges = button >= 0 && button <= itc::SPRITE_COUNT ? itc::EDGES_BY_HANDLE[button] : 0;
+		if (!snapTouch || !level || !edges) return touch;
+
+		const auto objLayer = level->m_objectLayer;
+		const auto pos = toVec2(objLayer->convertToNodeSpace(touch->getLocation()));
+		const float limit = toLevelDistance(itc::getAnchorSnapLimit(sprite(1)->getScale()));
+		const auto lines = getSnapLines();
+		const bool alongX = edges & (itc::EdgeLeft | itc::EdgeRight);
+		const bool alongY = edges & (itc::EdgeTop | itc::EdgeBottom);
+		itc::Vec2 snap;
+		bool isSnapped;
+		if (alongX && alongY) {
+			const auto anchor = toVec2(toLevel(sprite(1)->getPosition()));
+			const auto corner = toVec2(toLevel(sprite(button)->getPosition()));
+			isSnapped = lines.snapNearLine(pos, anchor, corner - anchor, limit, &snap);
+		} else {
+			const auto axis = getFrame().fromLocal(alongX ? itc::Vec2{1, 0} : itc::Vec2{0, 1});
+			isSnapped = lines.snapOnLine(pos, axis, limit, &snap);
+		}
+		auto view = touch->getLocationInView();
+		if (isSnapped) {
+			view = CCDirector::sharedDirector()->convertToUI(objLayer->convertToWorldSpace(toCCPoint(snap)));
+			*flags |= itc::GestureEvent::HandleSnapped;
+		}
+		// the touch is updated on every move, so its previous location is the previous result
+		snapTouch->setTouchInfo(touch->getID(), view.x, view.y);
+		return snapTouch;
+	}
+
+	// transform control coords (the parent of the sprites) <-> object layer coords
+	CCPoint toLevel(const CCPoint& p) {
+		const auto objLayer = LevelEditorLayer::get()->m_objectLayer;
+		return objLayer->convertToNodeSpace(sprite(1)->getParent()->convertToWorldSpace(p));
+	}
+
+	CCPoint fromLevel(const CCPoint& p) {
+		const auto objLayer = LevelEditorLayer::get()->m_objectLayer;
+		return sprite(1)->getParent()->convertToNodeSpace(objLayer->convertToWorldSpace(p));
+	}
+
+	float toLevelDistance(float dist) {
+		return (toLevel(ccp(dist, 0)) - toLevel(ccp(0, 0))).getLength();
+	}
+
+	// position of the anchor in object layer coords
+	CCPoint getAnchorInLevel() {
+		return toLevel(sprite(1)->getPosition());
+	}
+
+	// move the anchor to the center of the rect (the anchor is at 0,0 of m_mainNode).
+	// If the rect isn't rotated, it's the center of the selection bounds (object layer
+	// coords, nullptr if they aren't kept), otherwise it's taken from the handles
+	void centerAnchor(const itc::Rect* bounds) {
+		CCPoint center;
+		if (bounds && std::fmod(m_mainNode->getRotation(), 360.f) == 0) {
+			center = fromLevel(toCCPoint(bounds->center()));
+		} else {
+			const auto& frame = getFrame();
+			const auto& pos = frame.getHandles().m_pos;
+			center = toCCPoint(frame.fromLocal((pos[6] + pos[9]) / 2.f));
+		}
+		if (std::abs(center.x) <= MAX_FP_ERROR && std::abs(center.y) <= MAX_FP_ERROR) return;
+		sprite(1)->setPosition(center);
+		refreshControl();
+	}
+
+	ControlState saveState() {
+		return {m_mainNode->getRotation(), toVec2(sprite(1)->getPosition()), m_fields->m_disabledSpritesSnap,
+			m_fields->m_disabledSpritesRot, m_fields->m_lockedRotation, GLOBAL.m_isFreeRot};
+	}
+
+	// called after the activation, the rotation is restored by the injection (see loadValues())
+	void restoreState(const ControlState& state) {
+		sprite(1)->setPosition(toCCPoint(state.m_anchor));
+		refreshControl();
+		m_fields->m_disabledSpritesSnap = state.m_disabledSpritesSnap;
+		m_fields->m_lockedRotation = state.m_lockedRotation;
+		if (state.m_isFreeRot) {
+			GLOBAL.m_isFreeRot = true;
+			m_fields->m_rotBtn->setSprite(m_fields->m_rotSprites.get(true));
+			m_fields->m_disabledSpritesRot = state.m_disabledSpritesRot;
+			GLOBAL.m_isRotDirty = true; // the interface may be rotated relative to the objects
+		}
+		updateDisabledSprites();
+	}
+
+	// Free rotation: you can rotate the interface while the selected objects stay in place.
+	// When the controls are activated, RobTop takes their rotation from the main (first) 
+	// object of the selection in loadValues(). So while the free rotation angle is injected,
+	// we pass an object that has this angle instead. It isn't a part of the level or the 
+	// selection, so the selection array stays untouched.
+	void setInjectedRotation(float rot) {
+		m_fields->m_isRotationInjected = true;
+		m_fields->m_rotationObj->setRotation(rot);
+	}
+
+	void clearInjectedRotation() {
+		m_fields->m_isRotationInjected = false;
+	}
+
+	$override
+	void loadValues(GameObject* p0, CCArray* p1, gd::unordered_map<int, GameObjectEditorState>& p2) {
+		if (m_fields->m_isRotationInjected && p0) {
+			m_fields->m_rotationObj->setPosition(p0->getPosition());
+			p0 = m_fields->m_rotationObj;
+		}
+		GJTransformControl::loadValues(p0, p1, p2);
+		// the cumulative transform of the controls starts again from the current objects
+		resetAppliedArgs();
+	}
+
+	$override
+	void refreshControl() {
+		GJTransformControl::refreshControl();
+		invalidateFrame();
+	}
 	
+	void updateGuideBtn() {
+		m_fields->m_guideBtn->setVisible(GLOBAL.m_settings.m_guideSnap);
+	}
+
+	// the overlay is updated a couple of times per second, only while the profiler is on
+	void updateProfilerSchedule() {
+		this->unschedule(schedule_selector(MyGJTransformControl::updateProfilerOverlay));
+		m_fields->m_profilerLabel->setVisible(false);
+		if (itc::Profiler::get().isEnabled()) {
+			this->schedule(schedule_selector(MyGJTransformControl::updateProfilerOverlay), .5f);
+		}
+	}
+
+	void updateProfilerOverlay(float dt) {
+		auto label = m_fields->m_profilerLabel;
+		auto& profiler = itc::Profiler::get();
+		label->setVisible(true);
+		std::string text = fmt::format("selection: {}", profiler.getLastSelectionSize());
+		for (int hook = 0; hook < itc::Profiler::HookCount; hook++) {
+			const auto& h = profiler.getCurrent((itc::Profiler::Hook)hook);
+			if (h.getCount() == 0) continue;
+			text += fmt::format("\n{}: p50 {:.3f} p99 {:.3f} max {:.3f} ms",
+				itc::Profiler::getHookName((itc::Profiler::Hook)hook), 
+				h.getPercentile(.5) / 1e6, h.getPercentile(.99) / 1e6, h.getMax() / 1e6);
+		}
+		label->setString(text.c_str());
+		// next to the top right corner of the rect
+		const auto corner = m_mainNode->convertToWorldSpace(sprite(7)->getPosition());
+		label->setPosition(this->convertToNodeSpace(corner) + ccp(10, 0));
+	}
+
+	// gesture recording: the state of the controls when the touch begins, then every touch
+	// event with the state after RobTop's code and after ours (see replay/)
+	void startRecording() {
+		auto& header = m_fields->m_recording.m_header;
+		header.m_flags = 0;
+		if (GLOBAL.m_isSnap) header.m_flags |= itc::GestureHeader::Snap;
+		if (GLOBAL.m_isFreeRot) header.m_flags |= itc::GestureHeader::FreeRot;
+		if (GLOBAL.m_settings.m_centerSnap) header.m_flags |= itc::GestureHeader::CenterSnap;
+		if (GLOBAL.m_settings.m_objectSnap) header.m_flags |= itc::GestureHeader::ObjectSnap;
+		header.m_selectionSize = (uint32_t)getSelectionSize();
+		header.m_anchorScale = sprite(1)->getScale();
+		header.m_lockedRotation = m_fields->m_lockedRotation;
+		header.m_disabledSpritesSnap = m_fields->m_disabledSpritesSnap;
+		header.m_disabledSpritesRot = m_fields->m_disabledSpritesRot;
+		header.m_rotation = m_mainNode->getRotation();
+		header.m_anchor = toVec2(sprite(1)->getPosition());
+		header.m_handles = getHandlePositions();
+		m_fields->m_recording.m_events.clear();
+		// a few seconds of moves, so the recording doesn't grow during the drag
+		m_fields->m_recording.m_events.reserve(1024);
+		m_fields->m_recordingStart = std::chrono::duration<double>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+		m_fields->m_isRecording = true;
+	}
+
+	void recordControlState(itc::GestureEvent& event) {
+		event.m_rotation = m_mainNode->getRotation();
+		event.m_anchor = toVec2(sprite(1)->getPosition());
+		event.m_handles = getHandlePositions();
+	}
+
+	// start a new event (the state is overwritten after RobTop's code if it's called)
+	void makeRecordedEvent(itc::GestureEvent::Type type, CCTouch* touch) {
+		auto& event = m_fields->m_event;
+		event = {};
+		event.m_type = type;
+		event.m_buttonType = (uint8_t)m_transformButtonType;
+		const double now = std::chrono::duration<double>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+		event.m_time = (float)(now - m_fields->m_recordingStart);
+		event.m_touch = toVec2(sprite(1)->getParent()->convertToNodeSpace(touch->getLocation()));
+		recordControlState(event);
+	}
+
+	// finish the event with the state after the mod
+	void pushRecordedEvent() {
+		auto& event = m_fields->m_event;
+		event.m_resultRotation = m_mainNode->getRotation();
+		event.m_resultAnchor = toVec2(sprite(1)->getPosition());
+		event.m_resultDisabledSprites = getDisabledSprites();
+		m_fields->m_recording.m_events.push_back(event);
+	}
+
+	void saveRecording() {
+		m_fields->m_isRecording = false;
+		const auto dir = Mod::get()->getSaveDir() / "gestures";
+		std::error_code error;
+		std::filesystem::create_directories(dir, error);
+		const auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count();
+		const auto path = dir / fmt::format("gesture-{}.itcg", millis);
+		if (!m_fields->m_recording.save(path)) {
+			log::warn("Failed to save the gesture to {}", path.string());
+		}
+	}
+
+	$override
+	bool ccTouchBegan(CCTouch* p0, CCEvent* p1) {
+		if (GLOBAL.m_settings.m_recordGestures) startRecording();
+		m_fields->m_gestureMoves = 0;
+		m_fields->m_steadyAllocations = 0;
+		// the editor may add the undo object right here
+		beginTransformGesture();
+		if (!GJTransformControl::ccTouchBegan(p0, p1)) {
+			endTransformGesture();
+			m_fields->m_isRecording = false;
+			return false;
+		}
+		// the scale handles snap through a copy of the touch (see snapHandleTouch())
+		m_fields->m_snapTouch = nullptr;
+		if (GLOBAL.m_isSnap && !getSnapLines().empty()) {
+			auto touch = new CCTouch();
+			touch->autorelease();
+			const auto pos = p0->getLocationInView();
+			touch->setTouchInfo(p0->getID(), pos.x, pos.y);
+			m_fields->m_snapTouch = touch;
+		}
+		if (m_fields->m_isRecording) {
+			makeRecordedEvent(itc::GestureEvent::Began, p0);
+			pushRecordedEvent();
+		}
+		return true;
+	}
+
 	$override 
 	void ccTouchMoved(CCTouch* p0, CCEvent* p1) {
-		if (m_touchID != p0->m_nId) return;
+		if (GLOBAL.m_settings.m_coalesceMoves && m_touchID == p0->m_nId) {
+			bufferTouchMoved(p0);
+			return;
+		}
+		processTouchMoved(p0, p1);
+	}
+
+	// Moves can come several times per frame (high polling rate mice, some touchscreens).
+	// Only the last position is kept and it's applied once in the next frame. The previous
+	// location stays the one before the first buffered move, so the delta covers all of them
+	void bufferTouchMoved(CCTouch* touch) {
+		if (!m_fields->m_pendingTouch) {
+			auto pending = new CCTouch();
+			pending->autorelease();
+			m_fields->m_pendingTouch = pending;
+		}
+		if (!m_fields->m_hasPendingMove) m_fields->m_pendingPrevView = touch->getPreviousLocationInView();
+		// a copy: the dispatcher reuses the touch objects. setTouchInfo() moves the current
+		// location to the previous one, so the previous one is set first
+		const auto prev = m_fields->m_pendingPrevView;
+		const auto pos = touch->getLocationInView();
+		m_fields->m_pendingTouch->setTouchInfo(touch->getID(), prev.x, prev.y);
+		m_fields->m_pendingTouch->setTouchInfo(touch->getID(), pos.x, pos.y);
+		if (m_fields->m_hasPendingMove) return;
+		m_fields->m_hasPendingMove = true;
+		this->scheduleOnce(schedule_selector(MyGJTransformControl::onPendingTouchMoved), 0);
+	}
+
+	void onPendingTouchMoved(float dt) {
+		flushTouchMoved();
+	}
+
+	// apply the buffered move right now (before the touch ends)
+	void flushTouchMoved() {
+		if (!m_fields->m_hasPendingMove) return;
+		m_fields->m_hasPendingMove = false;
+		this->unschedule(schedule_selector(MyGJTransformControl::onPendingTouchMoved));
+		processTouchMoved(m_fields->m_pendingTouch, nullptr);
+	}
+
+	void processTouchMoved(CCTouch* p0, CCEvent* p1) {
+		ITC_PROFILE_SCOPE(TouchMoved, getSelectionSize());
+		const uint64_t allocations = itc::getAllocationCount();
+		const bool isRecording = m_fields->m_isRecording && m_touchID == p0->m_nId;
+		if (isRecording) makeRecordedEvent(itc::GestureEvent::Moved, p0);
+		// transformObjects() called from here is a part of the drag (see selection proxy)
+		GLOBAL.m_isInTouchMove = true;
+		const uint8_t flags = handleTouchMoved(p0, p1);
+		GLOBAL.m_isInTouchMove = false;
+		if (isRecording) {
+			m_fields->m_event.m_flags = flags;
+			pushRecordedEvent();
+		}
+		if (itc::isAllocationCounterEnabled()) countMoveAllocations(itc::getAllocationCount() - allocations);
+	}
+
+	// Debug (ITC_ALLOC_COUNTER builds): the first move of a gesture may allocate (the selection
+	// is gathered, the proxy is created...), the next ones shouldn't touch the heap at all.
+	// Allocations of RobTop's code called from the move are counted only on platforms where
+	// the mod's operator new replaces the game's one
+	void countMoveAllocations(uint64_t count) {
+		if (m_fields->m_gestureMoves++ > 0) m_fields->m_steadyAllocations += count;
+	}
+
+	void reportMoveAllocations() {
+		if (!itc::isAllocationCounterEnabled() || m_fields->m_gestureMoves < 2) return;
+		if (m_fields->m_steadyAllocations) {
+			log::warn("{} heap allocations in {} touch moves after the first one",
+				m_fields->m_steadyAllocations, m_fields->m_gestureMoves - 1);
+		} else {
+			log::debug("no heap allocations in {} touch moves", m_fields->m_gestureMoves - 1);
+		}
+		m_fields->m_gestureMoves = 0;
+	}
+
+	// returns what has snapped (itc::GestureEvent flags)
+	uint8_t handleTouchMoved(CCTouch* p0, CCEvent* p1) {
+		if (m_touchID != p0->m_nId) return 0;
 
 		// check if the current button is disabled, don't allow to use it
-		if (((uint16_t)0b1000000000000 >> m_transformButtonType) & getDisabledSprites()) {
-			return;
+		if (itc::isButtonDisabled(m_transformButtonType, getDisabledSprites())) {
+			return 0;
 		}
 
+		uint8_t flags = 0;
+		if (m_fields->m_snapTouch) p0 = snapHandleTouch(p0, &flags);
 		GJTransformControl::ccTouchMoved(p0, p1);
+		if (m_fields->m_isRecording) recordControlState(m_fields->m_event);
+
+		// everything except the anchor changes the rect
+		if (m_transformButtonType != 1) invalidateFrame();
 
 		// check anchor snaps
 		if (m_transformButtonType == 1) { // anchor
 			if (GLOBAL.m_isSnap) {
 				// check anchor snap
-				const auto anchor = spriteByTag(1);
+				const auto anchor = sprite(1);
 				auto aPos = anchor->getPosition();
 				// min dist after which the anchor snaps to the node
-				const float limit = anchor->getScale() * 18;
+				const float limit = itc::getAnchorSnapLimit(anchor->getScale());
 				uint8_t snapNodeIndx;
 				if (checkAnchorSnaps(limit, aPos, &aPos, &snapNodeIndx, GLOBAL.m_settings.m_centerSnap)) {
+					flags = itc::GestureEvent::AnchorSnapped;
+				} else if (GLOBAL.m_settings.m_objectSnap && checkAnchorSnapsToObjects(limit, aPos, &aPos)) {
+					flags = itc::GestureEvent::ObjectSnapped;
+				} else if (checkAnchorSnapsToLines(limit, aPos, &aPos)) {
+					flags = itc::GestureEvent::LineSnapped;
+				}
+				if (flags) {
 					// anchor was moved and we've just attached to the node
 					anchor->setColor(SNAP_COL);
 					anchor->setPosition(aPos);
@@ -328,18 +978,23 @@ class $modify(MyGJTransformControl, GJTransformControl) {
 		} else if (m_transformButtonType == 12) { // rot
 			if (GLOBAL.m_isSnap) {
 				// check rotation snap
-				const auto rotator = spriteByTag(12);
+				const auto rotator = sprite(12);
 				const float rot = m_mainNode->getRotation();
-				const int rotDiff = (int)(std::abs(rot) + 0.5) % 90;
-				const int deadzone = 2;
-				if (rotDiff <= deadzone || rotDiff >= 90 - deadzone) {
-					// make obj rot multiple of 90
-					int newRot = ((int)rot + 10 * (rot > 0 ? 1 : -1)) / 90 * 90;
+				float newRot;
+				uint8_t snapFlag = itc::GestureEvent::RotationSnapped;
+				bool isSnapped = itc::snapRotation(rot, &newRot);
+				if (!isSnapped && GLOBAL.m_settings.m_angleSnap && GLOBAL.m_isAngleHistogramReady) {
+					isSnapped = GLOBAL.m_angleHistogram.snap(rot, &newRot);
+					snapFlag = itc::GestureEvent::AngleSnapped;
+				}
+				if (isSnapped) {
+					// make obj rot multiple of 90 (or a common angle)
 					m_mainNode->setRotation(newRot);
 					if (!GLOBAL.m_isFreeRot) {
 						EditorUI::get()->transformRotationChanged(newRot);
 					}
 					rotator->setColor(SNAP_COL);
+					flags = snapFlag;
 				} else {
 					rotator->setColor(WHITE_COL);
 				}
@@ -354,31 +1009,40 @@ class $modify(MyGJTransformControl, GJTransformControl) {
 		if (GLOBAL.m_settings.m_showInterface == 3) {
 			m_fields->m_interface->setInterfaceVisibility(true, true);
 		}
+		return flags;
 	}
 
 	$override 
 	void ccTouchEnded(CCTouch* p0, CCEvent* p1) {
+		flushTouchMoved();
+		ITC_PROFILE_SCOPE(TouchEnded, getSelectionSize());
+		// apply the transform that was only previewed during the drag
+		commitSelectionProxy();
+		const bool isRecording = m_fields->m_isRecording && m_touchID == p0->m_nId;
+		if (isRecording) makeRecordedEvent(itc::GestureEvent::Ended, p0);
+
 		// check what sprites should be disabled depending on where the anchor snaps
 		// (we have to "disable" sprites that are aligned with the anchor because
 		// otherwise we will get the infinite scale when try to use them. In worst case
 		// this will cause the zero-division crash in RobTop's code)
-		const auto anchor = spriteByTag(1);
-		auto aPos = anchor->getPosition();
-		uint8_t snapNodeIndx = 0;
-
-		if (m_transformButtonType == 1 && GLOBAL.m_isSnap) { 
-			float limit = anchor->getScale() * 18; // min dist after which the anchor snaps to the node
-			checkAnchorSnaps(limit, aPos, &aPos, &snapNodeIndx, GLOBAL.m_settings.m_centerSnap);
-		} else {
-			// some sprites may still stay aligned with the anchor even after transform
-			checkAnchorIsOnEdge(MAX_FP_ERROR, aPos, &snapNodeIndx);
-		}
+		const auto anchor = sprite(1);
+		const uint8_t snapNodeIndx = itc::getAnchorReleaseNode(getFrame(), toVec2(anchor->getPosition()),
+			itc::getAnchorSnapLimit(anchor->getScale()), m_transformButtonType == 1 && GLOBAL.m_isSnap,
+			GLOBAL.m_settings.m_centerSnap, MAX_FP_ERROR);
 
 		setDisabledSpritesByNodeIndex(snapNodeIndx);
 
 		updateDisabledSprites();
+
+		if (isRecording) {
+			pushRecordedEvent();
+			saveRecording();
+		}
 		
 		GJTransformControl::ccTouchEnded(p0, p1);
+		m_fields->m_snapTouch = nullptr;
+		endTransformGesture();
+		reportMoveAllocations();
 
 		// interface (1 - never, 2 - always, 3 - on change)
 		if (GLOBAL.m_settings.m_showInterface == 3) {
@@ -388,7 +1052,17 @@ class $modify(MyGJTransformControl, GJTransformControl) {
 
 	$override 
 	void ccTouchCancelled(CCTouch* p0, CCEvent* p1) {
+		flushTouchMoved();
+		commitSelectionProxy();
+		if (m_fields->m_isRecording && m_touchID == p0->m_nId) {
+			makeRecordedEvent(itc::GestureEvent::Cancelled, p0);
+			pushRecordedEvent();
+			saveRecording();
+		}
 		GJTransformControl::ccTouchCancelled(p0, p1);
+		m_fields->m_snapTouch = nullptr;
+		endTransformGesture();
+		reportMoveAllocations();
 		// interface (1 - never, 2 - always, 3 - on change)
 		if (GLOBAL.m_settings.m_showInterface == 3) {
 			m_fields->m_interface->setInterfaceVisibility(false, false);
@@ -405,81 +1079,222 @@ class $modify(MyGJTransformControl, GJTransformControl) {
 		btn->setScale(1.f);		
 	}
 
+	static ButtonSprite* createPivotBtnSprite(bool isOn) {
+		auto spr = ButtonSprite::create("Each", "bigFont.fnt", isOn ? "GJ_button_02.png" : "GJ_button_04.png", .6f);
+		spr->setScale(.5f);
+		return spr;
+	}
+
+	// per object pivot: the selection is rotated / scaled with every object about its own
+	// pivot (the "object-pivot" setting) instead of the anchor
+	void onPivotBtn(CCObject* sender) {
+		GLOBAL.m_isObjectPivot = !GLOBAL.m_isObjectPivot;
+		m_fields->m_pivotBtn->setSprite(m_fields->m_pivotSprites.get(GLOBAL.m_isObjectPivot));
+	}
+
+	void onGuideBtn(CCObject* sender) {
+		if (!LevelEditorLayer::get()) return;
+		toggleGuides(getAnchorInLevel());
+	}
+
+	void onGroupBtn(CCObject* sender) {
+		GroupTransformPopup::create([](const GroupTransform& transform) {
+			transformGroup(transform);
+		})->show();
+	}
+
 	void onSnapBtn(CCObject* sender) {
 		GLOBAL.m_isSnap = !GLOBAL.m_isSnap;
-		auto spr = GLOBAL.m_isSnap ? "snapOnBtn_001.png"_spr : "snapOffBtn_001.png"_spr;
-		m_fields->m_snapBtn->setSprite(CCSprite::createWithSpriteFrameName(spr));
+		m_fields->m_snapBtn->setSprite(m_fields->m_snapSprites.get(GLOBAL.m_isSnap));
 	}
 
 	void onRotBtn(CCObject* sender) {
 		GLOBAL.m_isFreeRot = !GLOBAL.m_isFreeRot;
+		m_fields->m_rotBtn->setSprite(m_fields->m_rotSprites.get(GLOBAL.m_isFreeRot));
 		if (GLOBAL.m_isFreeRot) {
-			m_fields->m_rotBtn->setSprite(
-				CCSprite::createWithSpriteFrameName("freeRotOnBtn_001.png"_spr));
-			m_fields->m_disabledSpritesRot = 0b111111111110; // 1...11
+			m_fields->m_disabledSpritesRot = itc::FREE_ROT_DISABLED_SPRITES;
 			m_fields->m_lockedRotation = m_mainNode->getRotation();
 		} else {
-			m_fields->m_rotBtn->setSprite(
-				CCSprite::createWithSpriteFrameName("freeRotOffBtn_001.png"_spr));
 			m_fields->m_disabledSpritesRot = 0;
 			if (GLOBAL.m_isRotDirty) {
 				GLOBAL.m_freeRotFinalAngle = m_mainNode->getRotation();
-				EditorUI::get()->deactivateTransformControl();
-				EditorUI::get()->activateTransformControl(nullptr);
+				reopenTransformControl();
 				return;
 			}
 		}
 		updateDisabledSprites();
 	}
+
+	// Auto-fit: reopen the controls rotated to the minimum area rectangle around the
+	// selected objects (the same way as the free rotation does, see loadValues())
+	void onFitBtn(CCObject* sender) {
+		auto editor = EditorUI::get();
+		auto objs = editor->getSelectedObjects();
+		if (!objs || objs->count() == 0) return;
+		std::vector<itc::Vec2> points;
+		points.reserve(objs->count() * 4);
+		itc::Vec2 corners[4];
+		for (auto obj : CCArrayExt<GameObject*>(objs)) {
+			getObjectCorners(obj, corners);
+			points.insert(points.end(), std::begin(corners), std::end(corners));
+		}
+		const auto rect = itc::computeMinAreaRect(points, &itc::WorkerPool::shared());
+		// counterclockwise [0, 90) -> the closest clockwise rotation of the controls
+		const float rotation = rect.m_angle > 45 ? 90 - rect.m_angle : -rect.m_angle;
+
+		GLOBAL.m_freeRotFinalAngle = rotation;
+		GLOBAL.m_isRotDirty = true;
+		reopenTransformControl();
+	}
 };
 
 
-class $modify(MyEditorUI, EditorUI) {
-	// The purpose here is to implement free rotation for transform 
-	// controls. This means that you would be able to rotate the interface 
-	// while the selected objects stay in place. 
-	// The rotation value is set as soon as transform mode is activated inside the
-	// updateTransformControl() function. And it is equal to the rotation of the first 
-	// object in selection. 
-	// So the way the code below works is it puts an object with desired rotation in the first 
-	// position in selected objects array. Then this value is used to set the rotation for
-	// the transform controls, then this object is removed from array.
-
-	// P.S. I tried many other things to get this work, but it seems impossible to do 
-	// without affecting other parts of transform system (which either break everything or 
-	// don't let anything change). 
-	// And only this trick worked fine.
+void GJTransformControlInterface::rebuild(const itc::TransformFrame& frame) {
+	m_batch.clear();
+	if (m_visibleRect) {
+		const auto& pos = frame.getHandles().m_pos;
+		m_batch.addRect(toCCPoint(pos[6]), toCCPoint(pos[9]));
+		m_batch.addLine(toCCPoint(pos[4]), toCCPoint(pos[5]));
+		m_batch.addLine(toCCPoint(pos[2]), toCCPoint(pos[3]));
+	}
+	// if (m_visibleRot) {
+	// 	auto rotPos = m_transformControl->m_rotatePosition;
+	// 	m_batch.addLine(ccp(0,0), rotPos);
+	// }
+	for (const auto& [a, b] : m_overlayLines) {
+		m_batch.addLine(a, b);
+	}
+	m_frameVersion = frame.getVersion();
+	m_dirty = false;
+}
+
+void GJTransformControlInterface::draw() {
+	ITC_PROFILE_SCOPE(InterfaceDraw, getSelectionSize());
+	if (!m_visibleRect && !m_visibleRot && m_overlayLines.empty()) return;
+	const auto& frame = m_transformControl->getFrame();
+	if (m_dirty || frame.getVersion() != m_frameVersion) {
+		rebuild(frame);
+	}
+	m_batch.draw(GLOBAL.m_settings.m_interfaceCol);
+}
+
+
+class $modify(MyGJBaseGameLayer, GJBaseGameLayer) {
+	// collected during big transforms (see SectionBatch)
+	$override
+	void reorderObjectSection(GameObject* p0) {
+		if (SectionBatch::defer(p0)) return;
+		GJBaseGameLayer::reorderObjectSection(p0);
+	}
+};
 
+
+class $modify(MyLevelEditorLayer, LevelEditorLayer) {
+	// keep the object snap grid up to date
+
+	$override
+	GameObject* createObject(int p0, CCPoint p1, bool p2) {
+		auto obj = LevelEditorLayer::createObject(p0, p1, p2);
+		if (obj) {
+			updateObjectSnapPoints(obj);
+			if (GLOBAL.m_isObjectMapReady) GLOBAL.m_objectsById[obj->m_uniqueID] = obj;
+		}
+		return obj;
+	}
+
+	$override
+	void removeObject(GameObject* p0, bool p1) {
+		removeObjectSnapPoints(p0);
+		removeFromSelection(p0->m_uniqueID);
+		GLOBAL.m_objectsById.erase(p0->m_uniqueID);
+		LevelEditorLayer::removeObject(p0, p1);
+	}
+
+	// with compact undo the gesture's undo object is held back until the gesture ends
+	// (see MyEditorUI::endTransformGesture())
+	$override
+	void addToUndoList(UndoObject* p0, bool p1) {
+		if (GLOBAL.m_isInGesture && GLOBAL.m_settings.m_compactUndo && !GLOBAL.m_gestureUndo) {
+			GLOBAL.m_gestureUndo = p0;
+			GLOBAL.m_gestureUndoArg = p1;
+			return;
+		}
+		LevelEditorLayer::addToUndoList(p0, p1);
+	}
+};
+
+
+class $modify(MyEditorUI, EditorUI) {
 	struct Fields {
 		bool m_isActivate = false; // is activateTransformControl func on the call stack
-		bool m_isSneaky = false; // is the fake main object used
-		Ref<GameObject> m_sneakyObj;
+		// transforms since the controls loaded the objects are cumulative, this is the last
+		// one applied to the objects (see resetAppliedArgs())
+		TransformArgs m_appliedArgs;
+		bool m_isAppliedArgsStale = false; // the values were reloaded during the gesture
+		ObjectBatch m_batch; // gathered selection for the fast transform
+		// selection proxy (transform is applied to the objects when the gesture ends)
+		Ref<SelectionProxy> m_proxy;
+		Ref<CCArray> m_proxyObjs; // objects to transform, nullptr if there's no pending transform
+		TransformArgs m_proxyArgs;
+		bool m_isCommittingProxy = false;
+		Ref<SelectionOutlines> m_outlines; // shown during the gesture
+		Ref<GuideOverlay> m_guideOverlay;
+		// compact undo
+		itc::TransformHistory m_history;
+		int m_nextUndoMarker = UNDO_MARKER_TAG; // tag of the next marker (see pushTransformRecord())
+		TransformArgs m_gestureStartArgs; // m_appliedArgs when the gesture began
+		Ref<CCArray> m_gestureObjs; // objects transformed during the gesture
+		bool m_isPivotGesture = false; // the objects were transformed about their own pivots
+		bool m_isEditorGesture = false; // some move of the gesture went through RobTop's transformObjects()
+		// operations of the group transform (see applyTransformQueue())
+		itc::TransformQueue m_transformQueue;
+		// state of the controls of recently used selections (key is getSelectionKey())
+		itc::LruCache<uint64_t, ControlState> m_stateCache{8};
+		bool m_hasControlState = false; // the controls were activated for the current selection
+		bool m_isReloading = false; // see reloadTransformControl()
+		// deferred update of the controls (see flushTransformControl())
+		bool m_isUpdatePending = false;
+		bool m_isFlushingControl = false;
 		Fields() {
 			GLOBAL.m_isSnap = false;
+			GLOBAL.m_isObjectPivot = false;
 			GLOBAL.m_isFreeRot = false;
 			GLOBAL.m_isRotDirty = false;
 			GLOBAL.m_settings.update();
-			m_sneakyObj = GameObject::createWithKey(929);
-			m_sneakyObj->commonSetup();
-			m_sneakyObj->m_outerSectionIndex = -1;
+			GLOBAL.m_objectGrid.clear();
+			GLOBAL.m_isObjectGridReady = false;
+			GLOBAL.m_angleHistogram.clear();
+			GLOBAL.m_isAngleHistogramReady = false;
+			GLOBAL.m_objectsById.clear();
+			GLOBAL.m_isObjectMapReady = false;
+			GLOBAL.m_guides.clear();
+			clearSelection();
+			GLOBAL.m_isInGesture = false;
+			GLOBAL.m_gestureUndo = nullptr;
+		}
+		// the map holds the objects of the level
+		~Fields() {
+			GLOBAL.m_objectsById.clear();
+			GLOBAL.m_isObjectMapReady = false;
 		}
 	};
 
-	// $override
-	// void moveObject(GameObject* p0, CCPoint p1) {
-	// 	if (std::isnan(p1.x) || std::isnan(p1.y)) return;
-	// 	EditorUI::moveObject(p0, p1);
-	// }
+	$override
+	void moveObject(GameObject* p0, CCPoint p1) {
+		// if (std::isnan(p1.x) || std::isnan(p1.y)) return;
+		EditorUI::moveObject(p0, p1);
+		// objects of a gesture are updated once it ends (see endTransformGesture())
+		if (!GLOBAL.m_isInGesture) updateObjectSnapPoints(p0);
+		if (GLOBAL.m_selection.contains(p0->m_uniqueID)) GLOBAL.m_isSelectionMoved = true;
+		if (!m_fields->m_batch.isScattering()) {
+			m_fields->m_batch.reset(); // gathered state is outdated
+		}
+	}
 
 	$override 
 	void transformObjects(CCArray* objs, CCPoint anchor, float scaleX, float scaleY, 
 							float rotX, float rotY, float warpX, float warpY) {
-		// we don't need this object anymore
-		if (m_fields->m_isSneaky) {
-			m_selectedObjects->fastRemoveObjectAtIndex(0); // remove sneakyObj
-			m_fields->m_isSneaky = false;
-		}
-
+		ITC_PROFILE_SCOPE(TransformObjects, objs ? objs->count() : 0);
 		// fix RobTop's crash with extremely thin objects
 		auto editor = EditorUI::get();
 		if (warpX == 45 && warpY == 45) {
@@ -492,101 +1307,641 @@ class $modify(MyEditorUI, EditorUI) {
 		// auto obj = as<GameObject*>(objs->objectAtIndex(0));
 		// log::debug("rotX={}; rotY={}", obj->getRotationX(), obj->getRotationY());
 		// log::debug("anchor: {}, scaleX: {}, scaleY: {}, rotX: {}, rotY: {}, warpX: {}, warpY: {}", anchor, scaleX, scaleY, rotX, rotY, warpX, warpY);
-		EditorUI::transformObjects(objs, anchor, scaleX, scaleY, rotX, rotY, warpX, warpY);
-		return;
+		const TransformArgs args = {anchor, scaleX, scaleY, rotX, rotY, warpX, warpY};
+		if (GLOBAL.m_isInGesture) m_fields->m_gestureObjs = objs;
+
+		// warp and non-uniform scale always use the anchor
+		const bool isObjectPivot = GLOBAL.m_isObjectPivot && objs && args.isRigid();
+
+		// big selection: during the drag only transform the proxy
+		if (!isObjectPivot && !m_fields->m_isCommittingProxy && GLOBAL.m_isInTouchMove && GLOBAL.m_settings.m_proxyPreview
+				&& objs && (int)objs->count() >= GLOBAL.m_settings.m_proxyThreshold) {
+			updateSelectionProxy(objs, args);
+			return;
+		}
+
+		if (isObjectPivot) {
+			pivotTransformObjects(objs, args);
+			if (GLOBAL.m_isInGesture) m_fields->m_isPivotGesture = true;
+		} else if (GLOBAL.m_settings.m_fastTransform && objs && args.isRigid()
+				&& (int)objs->count() >= GLOBAL.m_settings.m_fastTransformThreshold) {
+			fastTransformObjects(objs, args);
+		} else {
+			m_fields->m_batch.reset(); // objects are changed by RobTop's code
+			if (GLOBAL.m_isInGesture) m_fields->m_isEditorGesture = true;
+			EditorUI::transformObjects(objs, anchor, scaleX, scaleY, rotX, rotY, warpX, warpY);
+		}
+		m_fields->m_appliedArgs = args;
+		GLOBAL.m_isSelectionMoved = true;
+		if (m_fields->m_outlines) m_fields->m_outlines->setDirty();
+
+		if (isTrackingObjects() && !GLOBAL.m_isInGesture) {
+			for (auto obj : CCArrayExt<GameObject*>(objs)) {
+				updateObjectSnapPoints(obj);
+			}
+		}
+	}
+
+	// the edit buttons (rotate, flip, scale) and paste / duplicate don't go through
+	// moveObject() or transformObjects(), their objects are updated here.
+	// A button press is one operation, it stays on RobTop's path (the transform queue is for
+	// several operations at once, see applyTransformQueue())
+
+	void editedObjects(CCArray* objs) {
+		updateObjectSnapPoints(objs);
+		GLOBAL.m_isSelectionMoved = true;
+		m_fields->m_batch.reset(); // gathered state is outdated
+	}
+
+	$override
+	void rotateObjects(CCArray* p0, float p1, CCPoint p2) {
+		EditorUI::rotateObjects(p0, p1, p2);
+		editedObjects(p0);
+	}
+
+	$override
+	void flipObjectsX(CCArray* p0) {
+		EditorUI::flipObjectsX(p0);
+		editedObjects(p0);
+	}
+
+	$override
+	void flipObjectsY(CCArray* p0) {
+		EditorUI::flipObjectsY(p0);
+		editedObjects(p0);
+	}
+
+	$override
+	void scaleObjects(CCArray* p0, float p1, float p2, CCPoint p3, ObjectScaleType p4, bool p5) {
+		EditorUI::scaleObjects(p0, p1, p2, p3, p4, p5);
+		editedObjects(p0);
+	}
+
+	// duplicate pastes a copy of the selection too
+	$override
+	CCArray* pasteObjects(gd::string const& p0, bool p1, bool p2) {
+		auto objs = EditorUI::pasteObjects(p0, p1, p2);
+		updateObjectSnapPoints(objs);
+		return objs;
+	}
+
+	void updateSelectionProxy(CCArray* objs, const TransformArgs& args) {
+		if (!m_fields->m_proxyObjs) {
+			// first move of the gesture
+			if (!m_fields->m_proxy) {
+				m_fields->m_proxy = SelectionProxy::create();
+				m_editorLayer->m_objectLayer->addChild(m_fields->m_proxy, 9999);
+			}
+			m_fields->m_proxyObjs = objs;
+			m_fields->m_proxy->snapshot(objs);
+			m_fields->m_proxy->setColor(GLOBAL.m_settings.m_interfaceCol);
+			m_fields->m_proxy->setVisible(true);
+			hideSelectionOutlines(); // the proxy shows the outlines
+		}
+		m_fields->m_proxyArgs = args;
+		// objects are already transformed by m_appliedArgs
+		m_fields->m_proxy->setTransform(args.relativeTo(m_fields->m_appliedArgs).m_matrix);
+	}
+
+	void fastTransformObjects(CCArray* objs, const TransformArgs& args) {
+		auto& batch = m_fields->m_batch;
+		if (!batch.isGatheredFrom(objs)) {
+			batch.gather(objs, m_fields->m_appliedArgs);
+		}
+		batch.apply(args);
+		scatterBatch(batch);
+	}
+
+	// every object is rotated / scaled about its own pivot, in one pass over the selection
+	void pivotTransformObjects(CCArray* objs, const TransformArgs& args) {
+		auto& batch = m_fields->m_batch;
+		const auto pivot = (ObjectBatch::Pivot)GLOBAL.m_settings.m_objectPivot;
+		if (!batch.isGatheredFrom(objs, pivot)) {
+			batch.gather(objs, m_fields->m_appliedArgs, pivot);
+		}
+		batch.apply(args);
+		scatterBatch(batch);
 	}
 
-	// adds a new object with given rotation to the selection
-	bool pushFakeMainObjectWithRotation(float rot) {
-		if (m_selectedObject != nullptr) {
-			// selected 1 obj
-			if (m_selectedObjects == nullptr) {
-				m_selectedObjects = CCArray::create();
-				m_selectedObjects->retain();
+	// write the batch to the objects. Its objects are moved to their new sections after
+	// all of them are written (RobTop's own transforms reorder them one by one)
+	void scatterBatch(ObjectBatch& batch) {
+		std::optional<SectionBatch> sections;
+		if (GLOBAL.m_settings.m_batchSections) sections.emplace(m_editorLayer);
+		batch.scatter(this);
+	}
+
+	// tag of the last entry of the editor undo / redo list (0 if it's empty)
+	static int getLastMarker(CCArray* list) {
+		if (!list || list->count() == 0) return 0;
+		return static_cast<CCObject*>(list->lastObject())->getTag();
+	}
+
+	// move the last entry of the list to the other one (undone / redone marker)
+	static void moveLastMarker(CCArray* from, CCArray* to) {
+		Ref<CCObject> marker = from->lastObject();
+		from->removeLastObject();
+		to->addObject(marker);
+	}
+
+	void beginTransformGesture() {
+		GLOBAL.m_isInGesture = true;
+		m_fields->m_gestureStartArgs = m_fields->m_appliedArgs;
+		m_fields->m_gestureObjs = nullptr;
+		m_fields->m_isPivotGesture = false;
+		m_fields->m_isEditorGesture = false;
+		if (GLOBAL.m_settings.m_showOutlines) showSelectionOutlines();
+		// the selection doesn't snap to its own angles
+		if (GLOBAL.m_settings.m_angleSnap && GLOBAL.m_isSnap) {
+			ensureAngleHistogram();
+			if (auto objs = getSelectedObjects()) {
+				for (auto obj : CCArrayExt<GameObject*>(objs)) {
+					GLOBAL.m_angleHistogram.exclude(obj->m_uniqueID);
+				}
 			}
-			m_selectedObjects->addObject(m_fields->m_sneakyObj);
-			m_selectedObjects->addObject(m_selectedObject);
-			m_fields->m_sneakyObj->setPosition(m_selectedObject->getPosition());
-			m_fields->m_sneakyObj->setRotation(rot);
-			m_selectedObject = nullptr;
-
-		} else if (m_selectedObjects != nullptr && m_selectedObjects->count() > 0) {
-			// selected 2+ objects
-			auto first = static_cast<GameObject*>(m_selectedObjects->firstObject());
-			m_selectedObjects->addObject(first);
-			m_selectedObjects->replaceObjectAtIndex(0, m_fields->m_sneakyObj);
-			m_fields->m_sneakyObj->setPosition(first->getPosition());
-			m_fields->m_sneakyObj->setRotation(rot);
+		}
+	}
+
+	void showSelectionOutlines() {
+		auto objs = getSelectedObjects();
+		if (!objs || objs->count() == 0) return;
+		if (!m_fields->m_outlines) {
+			m_fields->m_outlines = SelectionOutlines::create();
+			m_editorLayer->m_objectLayer->addChild(m_fields->m_outlines, 9999);
+		}
+		m_fields->m_outlines->setObjects(objs);
+		m_fields->m_outlines->setColor(GLOBAL.m_settings.m_interfaceCol);
+		m_fields->m_outlines->setVisible(true);
+	}
+
+	void hideSelectionOutlines() {
+		if (!m_fields->m_outlines) return;
+		m_fields->m_outlines->clear();
+		m_fields->m_outlines->setVisible(false);
+	}
+
+	// guides are toggled per axis: the ones the point is on are removed, if there are none,
+	// a vertical and a horizontal guide are added through the point
+	void toggleGuides(const CCPoint& levelPos) {
+		auto& guides = GLOBAL.m_guides;
+		const bool removedX = guides.remove(itc::Vertical, levelPos.x, GUIDE_TOGGLE_DIST);
+		const bool removedY = guides.remove(itc::Horizontal, levelPos.y, GUIDE_TOGGLE_DIST);
+		if (!removedX && !removedY) {
+			guides.add(itc::Vertical, levelPos.x, GUIDE_TOGGLE_DIST);
+			guides.add(itc::Horizontal, levelPos.y, GUIDE_TOGGLE_DIST);
+		}
+		if (!m_fields->m_guideOverlay) {
+			m_fields->m_guideOverlay = GuideOverlay::create(&guides);
+			m_editorLayer->m_objectLayer->addChild(m_fields->m_guideOverlay, 9999);
+		}
+		m_fields->m_guideOverlay->setColor(GLOBAL.m_settings.m_interfaceCol);
+		updateGuideOverlay();
+	}
+
+	// the guides are kept while the setting is off (they're back when it's turned on again)
+	// but they're not drawn and nothing snaps to them
+	void updateGuideOverlay() {
+		if (m_fields->m_guideOverlay) {
+			m_fields->m_guideOverlay->setVisible(GLOBAL.m_settings.m_guideSnap);
+		}
+	}
+
+	// (re)build the histogram of object angles if it's not up to date
+	void ensureAngleHistogram() {
+		if (GLOBAL.m_isAngleHistogramReady) return;
+		auto& histogram = GLOBAL.m_angleHistogram;
+		histogram.clear();
+		for (auto obj : CCArrayExt<GameObject*>(m_editorLayer->m_objects)) {
+			updateObjectAngle(obj);
+		}
+		GLOBAL.m_isAngleHistogramReady = true;
+	}
+
+	// Compact undo: a rigid transform gesture done by the fast transform is stored as one
+	// TransformHistory record (object ids + the transform) instead of the editor's undo
+	// object, and undone by applying the inverse transform to the objects. Gestures that went
+	// through RobTop's code keep his snapshot: the inverse wouldn't undo what it rounds
+	void endTransformGesture() {
+		GLOBAL.m_isInGesture = false;
+		const TransformArgs end = m_fields->m_appliedArgs;
+		if (m_fields->m_isAppliedArgsStale) resetAppliedArgs();
+		// scratch memory of the gesture is kept for the next one
+		itc::ScratchArena::gesture().reset();
+		hideSelectionOutlines();
+		Ref<CCArray> objs = m_fields->m_gestureObjs;
+		m_fields->m_gestureObjs = nullptr;
+		// snap points of the transformed objects weren't updated during the drag (moving
+		// the objects between the grid cells allocates)
+		if (objs && isTrackingObjects()) {
+			for (auto obj : CCArrayExt<GameObject*>(objs)) {
+				updateObjectSnapPoints(obj);
+			}
+		}
+		GLOBAL.m_angleHistogram.includeAll();
+		Ref<UndoObject> undo = GLOBAL.m_gestureUndo;
+		GLOBAL.m_gestureUndo = nullptr;
+		const bool isPivotGesture = m_fields->m_isPivotGesture;
+		const bool isEditorGesture = m_fields->m_isEditorGesture;
+		m_fields->m_isPivotGesture = false;
+		m_fields->m_isEditorGesture = false;
+		// the rect of the controls was transformed about the anchor, fit it to the objects again
+		if (isPivotGesture) reloadTransformControl();
+		if (!undo) return;
+
+		const auto& start = m_fields->m_gestureStartArgs;
+		if (!objs || isPivotGesture || isEditorGesture || !start.isRigid() || !end.isRigid()) {
+			// can't be described by the record, give the undo object back to the editor
+			m_editorLayer->addToUndoList(undo, GLOBAL.m_gestureUndoArg);
+			return;
+		}
+		pushTransformRecord(objs, end.relativeTo(start));
+	}
+
+	void pushTransformRecord(CCArray* objs, const itc::ObjectTransform& transform) {
+		std::vector<int> ids;
+		ids.reserve(objs->count());
+		for (auto obj : CCArrayExt<GameObject*>(objs)) {
+			ids.push_back(obj->m_uniqueID);
+		}
+		std::sort(ids.begin(), ids.end());
+		ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+		const double time = std::chrono::duration<double>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+		auto& history = m_fields->m_history;
+		int marker = getLastMarker(m_editorLayer->m_undoObjects);
+		if (!history.canMerge(ids, marker, time)) {
+			// The record gets a marker in the editor undo list: an empty transform undo
+			// object with a unique tag, so undo / redo know when it's the record's turn
+			auto undo = UndoObject::createWithTransformObjects(CCArray::create(), UndoCommand::Transform);
+			marker = m_fields->m_nextUndoMarker++;
+			undo->setTag(marker);
+			m_editorLayer->addToUndoList(undo, false);
+		}
+		// a new action, what was undone can't be redone anymore
+		if (m_editorLayer->m_redoObjects) m_editorLayer->m_redoObjects->removeAllObjects();
+		// the marker of a record dropped from the history would undo nothing
+		if (const int dropped = history.push(std::move(ids), transform, marker, time)) {
+			removeMarker(m_editorLayer->m_undoObjects, dropped);
+		}
+	}
+
+	static void removeMarker(CCArray* list, int marker) {
+		if (!list) return;
+		for (unsigned i = 0; i < list->count(); i++) {
+			if (static_cast<CCObject*>(list->objectAtIndex(i))->getTag() == marker) {
+				list->removeObjectAtIndex(i);
+				return;
+			}
+		}
+	}
+
+	// Transform queue: rotate / scale / mirror / move operations are queued and applied
+	// to the objects at once (one ObjectBatch pass for all of them, one undo entry)
+	void applyTransformQueue(CCArray* objs) {
+		auto& queue = m_fields->m_transformQueue;
+		if (queue.empty() || !objs || objs->count() == 0) {
+			queue.clear();
+			return;
+		}
+		commitSelectionProxy();
+		const auto transform = queue.getTransform();
+		queue.clear();
+		applyObjectTransform(objs, transform);
+	}
+
+	// Group transform ("Group" button of the controls): the operations are queued about the
+	// center of the group and applied to every object of the group straight from the level's
+	// group array: no selection is built and the objects aren't highlighted
+	void transformGroup(const GroupTransform& transform) {
+		const auto pivot = getGroupPivot(transform.m_groupID);
+		auto& queue = m_fields->m_transformQueue;
+		if (transform.m_rotation != 0) queue.rotate(transform.m_rotation, pivot);
+		if (transform.m_scale != 1) queue.scale(transform.m_scale, pivot);
+		if (transform.m_flipX) queue.mirrorX(pivot);
+		if (transform.m_flipY) queue.mirrorY(pivot);
+		applyTransformQueue(m_editorLayer->getGroup(transform.m_groupID));
+		// selected objects may be in the group
+		reloadTransformControl();
+	}
+
+	// center of the bounds of the group's objects, the same center as the rect of the
+	// controls (see centerAnchor()). One pass over the group array
+	itc::Vec2 getGroupPivot(int groupID) {
+		auto objs = m_editorLayer->getGroup(groupID);
+		if (!objs || objs->count() == 0) return {};
+		itc::Rect bounds;
+		bool first = true;
+		for (auto obj : CCArrayExt<GameObject*>(objs)) {
+			const auto rect = getObjectBounds(obj);
+			if (first) {
+				bounds = rect;
+				first = false;
+				continue;
+			}
+			bounds.m_min = {std::min(bounds.m_min.x, rect.m_min.x), std::min(bounds.m_min.y, rect.m_min.y)};
+			bounds.m_max = {std::max(bounds.m_max.x, rect.m_max.x), std::max(bounds.m_max.y, rect.m_max.y)};
+		}
+		return bounds.center();
+	}
+
+	// transform the objects in one pass, with one undo entry
+	void applyObjectTransform(CCArray* objs, const itc::ObjectTransform& transform) {
+		if (GLOBAL.m_settings.m_compactUndo) {
+			pushTransformRecord(objs, transform);
 		} else {
-			// nothing is selected
-			return false;
+			m_editorLayer->addToUndoList(UndoObject::createWithTransformObjects(objs, UndoCommand::Transform), false);
 		}
-		return true;
+
+		ObjectBatch batch;
+		batch.gather(objs, {});
+		batch.apply(transform);
+		scatterBatch(batch);
+		m_fields->m_batch.reset();
+		GLOBAL.m_isSelectionMoved = true;
+		if (isTrackingObjects()) {
+			for (auto obj : CCArrayExt<GameObject*>(objs)) {
+				updateObjectSnapPoints(obj);
+			}
+		}
+	}
+
+	// apply the record (or its inverse) to the objects that are still in the level
+	void applyTransformRecord(const itc::TransformRecord& record, bool inverse) {
+		Ref<CCArray> objs = findObjects(record.m_ids);
+		ObjectBatch batch;
+		batch.gather(objs, {});
+		batch.apply(inverse ? record.m_transform.inverse() : record.m_transform);
+		scatterBatch(batch);
+		// the controls must load the new state of the objects
+		reloadTransformControl();
+	}
+
+	// objects of the ids that are still in the level (GLOBAL.m_objectsById is rebuilt at most
+	// once, if some id isn't in it)
+	CCArray* findObjects(const std::vector<int>& ids) {
+		auto& map = GLOBAL.m_objectsById;
+		auto objs = CCArray::create();
+		bool isRebuilt = false;
+		for (const int id : ids) {
+			auto it = map.find(id);
+			if (it == map.end() && !isRebuilt) {
+				rebuildObjectMap();
+				isRebuilt = true;
+				it = map.find(id);
+			}
+			if (it != map.end()) objs->addObject(it->second);
+		}
+		return objs;
+	}
+
+	void rebuildObjectMap() {
+		auto& map = GLOBAL.m_objectsById;
+		map.clear();
+		for (auto obj : CCArrayExt<GameObject*>(m_editorLayer->m_objects)) {
+			map[obj->m_uniqueID] = obj;
+		}
+		GLOBAL.m_isObjectMapReady = true;
+	}
+
+	// reopen the controls after the objects were changed. The saved control state
+	// belongs to the old transforms, so it isn't cached or restored
+	void reloadTransformControl() {
+		if (!m_transformControl || !m_transformControl->isVisible()) return;
+		m_fields->m_isReloading = true;
+		reopenTransformControl();
+		m_fields->m_isReloading = false;
+	}
+
+	// the mod's own reopens (free rotation, auto-fit, reload)
+	void reopenTransformControl() {
+		deactivateTransformControl();
+		activateTransformControl(nullptr);
+	}
+
+	// order independent hash of the selected objects and their transforms, kept by the
+	// select / deselect hooks. The parts of the objects are only recomputed after they
+	// were changed (once, not on every call)
+	uint64_t getSelectionKey() {
+		refreshSelection();
+		return GLOBAL.m_selectionKey.get();
+	}
+
+	// bounds of the selection, kept the same way as the key
+	const itc::SelectionBounds& getSelectionBounds() {
+		refreshSelection();
+		return GLOBAL.m_selectionBounds;
+	}
+
+	// RobTop puts the controls at the center of the selection: a pass over every selected
+	// object on each activation / update. The center of the kept bounds is the same point
+	$override
+	CCPoint getGroupCenter(CCArray* p0, bool p1) {
+		if (!GLOBAL.m_settings.m_cacheSelectionBounds || p1 || !p0 || p0 != m_selectedObjects
+				|| p0->count() == 0) {
+			return EditorUI::getGroupCenter(p0, p1);
+		}
+		const auto& bounds = getSelectionBounds();
+		if (bounds.size() != p0->count()) return EditorUI::getGroupCenter(p0, p1);
+		return toCCPoint(bounds.getCenter());
+	}
+
+	// cache the state of the controls for the selection they were activated for
+	// (called before the selection changes)
+	void saveControlState() {
+		if (!m_fields->m_hasControlState) return;
+		m_fields->m_hasControlState = false;
+		// the selection was changed without the hooks, it's not the one of the controls anymore
+		if (m_fields->m_isReloading || GLOBAL.m_selection.size() != getSelectionSize()) return;
+		if (auto controls = GLOBAL.m_transformControls) {
+			m_fields->m_stateCache.put(getSelectionKey(), controls->saveState());
+		}
+	}
+
+	$override
+	void deactivateTransformControl() {
+		// nothing to rebuild anymore
+		cancelControlFlush();
+		saveControlState();
+		EditorUI::deactivateTransformControl();
+	}
+
+	// RobTop's loadValues() (on activation, and on every update of the controls after the
+	// selection or the objects changed) restarts the cumulative arguments of the controls.
+	// During a gesture it's done once the gesture ends, the record needs the last arguments
+	void resetAppliedArgs() {
+		if (GLOBAL.m_isInGesture) {
+			m_fields->m_isAppliedArgsStale = true;
+			return;
+		}
+		m_fields->m_isAppliedArgsStale = false;
+		m_fields->m_appliedArgs = {};
+		m_fields->m_batch.reset();
+	}
+
+	void commitSelectionProxy() {
+		if (!m_fields->m_proxyObjs) return;
+		Ref<CCArray> objs = m_fields->m_proxyObjs;
+		m_fields->m_proxyObjs = nullptr;
+		const auto& args = m_fields->m_proxyArgs;
+		m_fields->m_isCommittingProxy = true;
+		transformObjects(objs, args.m_anchor, args.m_scaleX, args.m_scaleY, 
+			args.m_rotX, args.m_rotY, args.m_warpX, args.m_warpY);
+		m_fields->m_isCommittingProxy = false;
+		m_fields->m_proxy->clear();
+		m_fields->m_proxy->setVisible(false);
+	}
+
+	// Selection tracking: objects are added to / removed from GLOBAL.m_selection (and the
+	// selection key) one by one when they're selected / deselected, so growing a big
+	// selection doesn't rescan it. The state of the controls is saved before the change.
+	// The gathered batch is dropped: the editor may reuse the selection array for other
+	// objects (see ObjectBatch::isGatheredFrom())
+
+	$override
+	void selectObject(GameObject* p0, bool p1) {
+		saveControlState();
+		EditorUI::selectObject(p0, p1);
+		m_fields->m_batch.reset();
+		if (p0) addToSelection(p0);
+	}
+
+	$override
+	void selectObjects(CCArray* p0, bool p1) {
+		saveControlState();
+		EditorUI::selectObjects(p0, p1);
+		m_fields->m_batch.reset();
+		if (!p0) return;
+		for (auto obj : CCArrayExt<GameObject*>(p0)) {
+			addToSelection(obj);
+		}
+	}
+
+	$override
+	void deselectObject(GameObject* p0) {
+		saveControlState();
+		EditorUI::deselectObject(p0);
+		m_fields->m_batch.reset();
+		if (p0) removeFromSelection(p0->m_uniqueID);
 	}
 
+	$override
+	void deselectAll() {
+		saveControlState();
+		EditorUI::deselectAll();
+		m_fields->m_batch.reset();
+		clearSelection();
+	}
+
+	void rebuildSelection() {
+		clearSelection();
+		if (m_selectedObject) addToSelection(m_selectedObject);
+		if (m_selectedObjects) {
+			for (auto obj : CCArrayExt<GameObject*>(m_selectedObjects)) {
+				addToSelection(obj);
+			}
+		}
+	}
+
+	// catch the selection changes the hooks didn't see (cheap check of the count)
+	void syncSelection() {
+		if (GLOBAL.m_selection.size() != getSelectionSize()) rebuildSelection();
+	}
+
+	// the objects are moved by the moveObject() / transformObjects() / edit hooks, which only
+	// mark the selection as outdated: it's rebuilt once, when it's read
+	void refreshSelection() {
+		syncSelection();
+		if (GLOBAL.m_isSelectionMoved) rebuildSelection();
+	}
+
+	// Deferred control updates: bulk selection changes can update the controls several
+	// times per frame. Instead, the controls are marked dirty and updated once at the next
+	// frame (and not at all if they're hidden or activated by then). Activations aren't
+	// deferred: RobTop's code reads the controls right after activating them
+	bool shouldDeferControl() {
+		return GLOBAL.m_settings.m_deferControlUpdates && !m_fields->m_isFlushingControl
+			&& !m_fields->m_isActivate && !GLOBAL.m_isInGesture;
+	}
+
+	void scheduleControlFlush() {
+		if (m_fields->m_isUpdatePending) return;
+		m_fields->m_isUpdatePending = true;
+		this->scheduleOnce(schedule_selector(MyEditorUI::onControlFlush), 0);
+	}
+
+	void cancelControlFlush() {
+		if (!m_fields->m_isUpdatePending) return;
+		m_fields->m_isUpdatePending = false;
+		this->unschedule(schedule_selector(MyEditorUI::onControlFlush));
+	}
+
+	void onControlFlush(float dt) {
+		flushTransformControl();
+	}
+
+	// apply the deferred update right now
+	void flushTransformControl() {
+		if (!m_fields->m_isUpdatePending) return;
+		cancelControlFlush();
+		if (!m_transformControl || !m_transformControl->isVisible()) return;
+		m_fields->m_isFlushingControl = true;
+		updateTransformControl();
+		m_fields->m_isFlushingControl = false;
+	}
 
 	$override 
 	void updateTransformControl() {
-		// if the function is called from activateTransformControl()
-		if (m_fields->m_isActivate && GLOBAL.m_isRotDirty) {
-			float rot = GLOBAL.m_freeRotFinalAngle;
-			if (pushFakeMainObjectWithRotation(rot)) {
-				m_fields->m_isSneaky = true;
-			}
+		if (shouldDeferControl()) {
+			scheduleControlFlush();
+			return;
+		}
+		ITC_PROFILE_SCOPE(UpdateTransformControl, getSelectionSize());
+		// if the function is called from activateTransformControl(), the controls
+		// get the free rotation angle instead of the main object rotation (see loadValues())
+		auto controls = GLOBAL.m_transformControls;
+		const bool injectRotation = controls && m_fields->m_isActivate && GLOBAL.m_isRotDirty;
+		if (injectRotation) {
+			controls->setInjectedRotation(GLOBAL.m_freeRotFinalAngle);
 			GLOBAL.m_isRotDirty = false;
 		}
 
 		EditorUI::updateTransformControl();
 
-		// Now fix everything that we might have messed up
-
-		// in case transformObjects() was not reached
-		if (m_fields->m_isSneaky) {
-			m_selectedObjects->fastRemoveObjectAtIndex(0); // remove sneakyObj
-			m_fields->m_isSneaky = false;
-		}
-
-		if (m_fields->m_isActivate) {
-			// handle situation when only one object is selected
-			if (m_selectedObjects && m_selectedObjects->count() == 1) {
-				auto obj = m_selectedObjects->objectAtIndex(0);
-				m_selectedObjects->removeObjectAtIndex(0);
-				m_selectedObject = static_cast<GameObject*>(obj);
-				// m_transformControl->m_unk1 and editor->m_selectedObjects are the same array,
-				// but when only one object is selected, they must be different
-				CC_SAFE_RELEASE(m_transformControl->m_unk1);
-				m_transformControl->m_unk1 = CCArray::createWithObject(obj);
-				m_transformControl->m_unk1->retain();
-			}
+		if (controls) {
+			if (injectRotation) controls->clearInjectedRotation();
+			controls->invalidateFrame();
+		}
+
+		syncSelection();
 
-			// if (GLOBAL.m_transformControls) {
-			// 	// fix issue that center isn't centered sometimes
-			// 	// (RobTop uses the center of a group of selected objects, which sometimes 
-			// 	// does not match the center of the interface rectangle, which looks cursed)
-			// 	const auto controls = GLOBAL.m_transformControls;
-			// 	auto anchor = controls->spriteByTag(1);
-			// 	auto spr1 = controls->spriteByTag(9);
-			// 	auto spr2 = controls->spriteByTag(6);
-			// 	// actual center coordinates (now center is at 0,0)
-			// 	auto diff = (spr2->getPosition() + spr1->getPosition()) / 2;
-			// 	if (diff.x > MAX_FP_ERROR || diff.y > MAX_FP_ERROR) {
-			// 		const float rotation = -controls->m_mainNode->getRotation();
-			// 		const double sin = std::sin(rotation*M_PI/180.0);
-			// 		const double cos = std::cos(rotation*M_PI/180.0);
-			// 		const auto anchorRelPos = ccp(
-			//			cos * diff.x - sin * diff.y, sin * diff.x + cos * diff.y);
-					
-			// 		anchor->setPosition(anchorRelPos);
-			// 		controls->refreshControl();
-			// 	}
-			// }
+		if (m_fields->m_isActivate && controls && GLOBAL.m_settings.m_centerAnchor) {
+			// fix issue that center isn't centered sometimes
+			// (RobTop uses the center of a group of selected objects, which sometimes 
+			// does not match the center of the interface rectangle, which looks cursed)
+			const itc::Rect* bounds = nullptr;
+			if (GLOBAL.m_settings.m_cacheSelectionBounds) {
+				const auto& selection = getSelectionBounds();
+				if (selection.size() > 0) bounds = &selection.getBounds();
+			}
+			controls->centerAnchor(bounds);
 		}
 	}
 
 	// prevent undo/redo bugs
 	$override
 	void undoLastAction(CCObject* p0) {
-		EditorUI::undoLastAction(p0);
+		if (auto record = m_fields->m_history.undo(getLastMarker(m_editorLayer->m_undoObjects))) {
+			moveLastMarker(m_editorLayer->m_undoObjects, m_editorLayer->m_redoObjects);
+			GLOBAL.m_isSelectionMoved = true;
+			applyTransformRecord(*record, true);
+		} else {
+			EditorUI::undoLastAction(p0);
+		}
+		GLOBAL.m_isSelectionMoved = true;
+		GLOBAL.m_isObjectGridReady = false; // rebuild snap grid next time
+		GLOBAL.m_isAngleHistogramReady = false;
+		m_fields->m_batch.reset();
+		flushTransformControl(); // the controls are checked right now
 		if (auto controls = GLOBAL.m_transformControls) {
 			if (controls->isVisible()) {
 				controls->checkAndUpdateDisabledSpritesForCurrentAnchorPosition();
@@ -596,7 +1951,18 @@ class $modify(MyEditorUI, EditorUI) {
 
 	$override
 	void redoLastAction(CCObject* p0) {
-		EditorUI::redoLastAction(p0);
+		if (auto record = m_fields->m_history.redo(getLastMarker(m_editorLayer->m_redoObjects))) {
+			moveLastMarker(m_editorLayer->m_redoObjects, m_editorLayer->m_undoObjects);
+			GLOBAL.m_isSelectionMoved = true;
+			applyTransformRecord(*record, false);
+		} else {
+			EditorUI::redoLastAction(p0);
+		}
+		GLOBAL.m_isSelectionMoved = true;
+		GLOBAL.m_isObjectGridReady = false; // rebuild snap grid next time
+		GLOBAL.m_isAngleHistogramReady = false;
+		m_fields->m_batch.reset();
+		flushTransformControl(); // the controls are checked right now
 		if (auto controls = GLOBAL.m_transformControls) {
 			if (controls->isVisible()) {
 				controls->checkAndUpdateDisabledSpritesForCurrentAnchorPosition();
@@ -606,10 +1972,29 @@ class $modify(MyEditorUI, EditorUI) {
 
 	$override 
 	void activateTransformControl(CCObject* p0) {
+		// the activation updates the controls
+		cancelControlFlush();
+		ITC_PROFILE_SCOPE(ActivateTransformControl, getSelectionSize());
+		// the selection can change without the deactivation
+		saveControlState();
+		// cached state of the selection (the free rotation angle being applied goes first)
+		const bool isCached = GLOBAL.m_settings.m_cacheControlState && getSelectionSize() > 0;
+		std::optional<ControlState> cached;
+		if (isCached && !m_fields->m_isReloading && !GLOBAL.m_isRotDirty) {
+			if (auto state = m_fields->m_stateCache.get(getSelectionKey())) {
+				cached = *state;
+			}
+		}
+
 		if (auto controls = GLOBAL.m_transformControls) {
 			controls->prepareToActivate();
 		}
+		if (cached) {
+			GLOBAL.m_freeRotFinalAngle = cached->m_rotation;
+			GLOBAL.m_isRotDirty = true;
+		}
 
+		resetAppliedArgs();
 		m_fields->m_isActivate = true;
 		EditorUI::activateTransformControl(p0);
 		m_fields->m_isActivate = false;
@@ -618,9 +2003,87 @@ class $modify(MyEditorUI, EditorUI) {
 
 		if (auto controls = GLOBAL.m_transformControls) {
 			if (controls->isVisible()) {
+				if (cached) controls->restoreState(*cached);
 				controls->updateDisabledSprites();
+				m_fields->m_hasControlState = isCached;
 			}
 		}
 	}
 
 }; // :3
+
+void commitSelectionProxy() {
+	if (auto editor = static_cast<MyEditorUI*>(EditorUI::get())) {
+		editor->commitSelectionProxy();
+	}
+}
+
+void resetAppliedArgs() {
+	if (auto editor = static_cast<MyEditorUI*>(EditorUI::get())) {
+		editor->resetAppliedArgs();
+	}
+}
+
+void beginTransformGesture() {
+	if (auto editor = static_cast<MyEditorUI*>(EditorUI::get())) {
+		editor->beginTransformGesture();
+	}
+}
+
+void endTransformGesture() {
+	if (auto editor = static_cast<MyEditorUI*>(EditorUI::get())) {
+		editor->endTransformGesture();
+	}
+}
+
+void toggleGuides(const CCPoint& levelPos) {
+	if (auto editor = static_cast<MyEditorUI*>(EditorUI::get())) {
+		editor->toggleGuides(levelPos);
+	}
+}
+
+void transformGroup(const GroupTransform& transform) {
+	if (auto editor = static_cast<MyEditorUI*>(EditorUI::get())) {
+		editor->transformGroup(transform);
+	}
+}
+
+void reopenTransformControl() {
+	if (auto editor = static_cast<MyEditorUI*>(EditorUI::get())) {
+		editor->reopenTransformControl();
+	}
+}
+
+void updateGuideOverlay() {
+	if (auto editor = static_cast<MyEditorUI*>(EditorUI::get())) {
+		editor->updateGuideOverlay();
+	}
+}
+
+$on_mod(Loaded) {
+	itc::Profiler::get().setEnabled(Mod::get()->getSettingValue<bool>("profiler"));
+	listenForSettingChanges("profiler", [](bool value) {
+		itc::Profiler::get().setEnabled(value);
+		itc::Profiler::get().reset();
+		if (auto controls = GLOBAL.m_transformControls) controls->updateProfilerSchedule();
+	});
+	// the other settings are read when the editor is opened, this one can be turned off in it
+	listenForSettingChanges("snap-guides", [](bool value) {
+		GLOBAL.m_settings.m_guideSnap = value;
+		updateGuideOverlay();
+		if (auto controls = GLOBAL.m_transformControls) controls->updateGuideBtn();
+	});
+	// the setting works as a button: turning it on saves the csv, then it's turned off again
+	listenForSettingChanges("profiler-dump", [](bool value) {
+		if (!value) return;
+		Loader::get()->queueInMainThread([] {
+			Mod::get()->setSettingValue<bool>("profiler-dump", false);
+		});
+		const auto path = Mod::get()->getSaveDir() / "profile.csv";
+		if (auto res = utils::file::writeString(path, itc::Profiler::get().toCsv()); res.isErr()) {
+			Notification::create("Failed to save the profile", NotificationIcon::Error)->show();
+			return;
+		}
+		Notification::create(fmt::format("Profile saved to {}", path.string()), NotificationIcon::Success)->show();
+	});
+}